@@ -1,25 +1,45 @@
 #include "multigraph_cli.hpp"
 #include "core.hpp"
 #include "max_cycle.hpp"
+#include "max_cycle_solver.hpp"
 #include "hamilton.hpp"
 #include "metric.hpp"
+#include "assignment_metric.hpp"
+#include "anytime_metric.hpp"
+#include "distance_matrix.hpp"
+#include "similarity_index.hpp"
+#include "generator.hpp"
+#include "parallel.hpp"
+#include "vertex_order.hpp"
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <cctype>
 #include <chrono>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 MultigraphCLI::MultigraphCLI() {
     app_.description("CLI tool for working with multigraphs.");
     init_distance_command();
+    init_distance_matrix_command();
+    init_nearest_command();
     init_find_hamiltonian_extension_command();
     init_find_max_cycles_command();
+    init_generate_command();
     app_.require_subcommand(1, 1);
 
     app_.footer("Example:\n"
                 "  ./app distance file0.txt file1.txt -i 0 -j 1\n"
+                "  ./app distance_matrix graphs.txt --approx -t 0 -o distances.csv\n"
+                "  ./app nearest graphs.txt query.txt -j 0 -k 5\n"
                 "  ./app find_hamiltonian_extension graph.txt -i 0 -k 2\n"
-                "  ./app find_max_cycles graph.txt -i 0 -k 2 -p 10");
+                "  ./app find_hamiltonian_extension graph.txt -k 1..16 -t 0\n"
+                "  ./app find_max_cycles graph.txt -i 0 -k 2 -p 10\n"
+                "  ./app generate graphs.txt --family power-law -n 1000 -c 16 --seed 42 -t 0");
 }
 
 void MultigraphCLI::parse(int argc, char** argv) {
@@ -34,10 +54,16 @@ void MultigraphCLI::run() const {
     try {
         if (app_.got_subcommand("distance")) {
             execute_distance();
+        } else if (app_.got_subcommand("distance_matrix")) {
+            execute_distance_matrix();
+        } else if (app_.got_subcommand("nearest")) {
+            execute_nearest();
         } else if (app_.got_subcommand("find_hamiltonian_extension")) {
             execute_find_hamiltonian_extension();
         } else if (app_.got_subcommand("find_max_cycles")) {
             execute_find_max_cycles();
+        } else if (app_.got_subcommand("generate")) {
+            execute_generate();
         }
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
@@ -54,70 +80,313 @@ void MultigraphCLI::init_distance_command() {
         ->required()
         ->check(CLI::ExistingFile);
     cmd->add_option("-j,--index1", input2_.index, "Index of the multigraph in the second file")->default_val(0);
-    cmd->add_flag("--approx", approx_, "Use heuristic metric");
+    auto* approx = cmd->add_flag("--approx", approx_, "Use heuristic metric");
+    auto* assignment =
+        cmd->add_flag("--assignment", assignment_, "Use assignment-based upper bound metric")->excludes(approx);
     cmd->add_flag("--counting-sort", countSort_, "Use counting sort in heuristic metric");
     cmd->add_flag("--const-out-deg", constantOutDegrees_,
                   "Use constant-time vertex outgoing degree evaluation in heuristic metric");
+    cmd->add_option("-t,--threads", threads_, "Number of exact metric worker threads, 0 uses all hardware threads")
+        ->default_val(1);
+    cmd->add_option("--time-limit", time_limit_ms_,
+                    "Stop the search after the given number of milliseconds and report the bounds found")
+        ->excludes(approx)
+        ->excludes(assignment);
+}
+
+void MultigraphCLI::init_distance_matrix_command() {
+    auto* cmd = app_.add_subcommand("distance_matrix", "Calculate the distances between all multigraphs of files.");
+    cmd->add_option("file0", input1_.filepath, "Path to the multigraph file of the rows")
+        ->required()
+        ->check(CLI::ExistingFile);
+    cmd->add_option("file1", input2_.filepath, "Path to the multigraph file of the columns, defaults to file0")
+        ->check(CLI::ExistingFile);
+    auto* approx = cmd->add_flag("--approx", approx_, "Use heuristic metric");
+    cmd->add_flag("--assignment", assignment_, "Use assignment-based upper bound metric")->excludes(approx);
+    cmd->add_flag("--counting-sort", countSort_, "Use counting sort in heuristic metric");
+    cmd->add_option("-t,--threads", threads_, "Number of worker threads, 0 uses all hardware threads")
+        ->default_val(1);
+    cmd->add_option("-o,--output", output_path_, "Path of the written matrix, - for standard output")
+        ->default_val("-");
+    cmd->add_option("--format", format_, "Output format: csv or binary")
+        ->check(CLI::IsMember({"csv", "binary"}))
+        ->default_val("csv");
+    cmd->add_option("--nearest", nearest_, "Write only the given number of nearest columns of every row, 0 for all")
+        ->default_val(0);
+}
+
+void MultigraphCLI::init_nearest_command() {
+    auto* cmd = app_.add_subcommand("nearest", "Find the multigraphs of a collection closest to a query multigraph.");
+    cmd->add_option("collection", input1_.filepath, "Path to the file of indexed multigraphs")
+        ->required()
+        ->check(CLI::ExistingFile);
+    cmd->add_option("query", input2_.filepath, "Path to the file of the query multigraph")
+        ->required()
+        ->check(CLI::ExistingFile);
+    cmd->add_option("-j,--index", input2_.index, "Index of the query multigraph in its file")->default_val(0);
+    auto* k = cmd->add_option("-k", nearest_, "Number of closest multigraphs to find")->default_val(1);
+    cmd->add_option("--radius", radius_, "Find every multigraph within this distance instead")->excludes(k);
+    cmd->add_flag("--approx", approx_, "Use heuristic metric");
+    cmd->add_flag("--counting-sort", countSort_, "Use counting sort in heuristic metric");
+    cmd->add_option("-t,--threads", threads_, "Number of worker threads building the index, 0 uses all")
+        ->default_val(1);
 }
 
 void MultigraphCLI::init_find_hamiltonian_extension_command() {
     auto* cmd = app_.add_subcommand("find_hamiltonian_extension", "Find minimal k-Hamiltonian extension.");
     cmd->add_option("filepath", input0_.filepath, "Path to the multigraph file")->required()->check(CLI::ExistingFile);
     cmd->add_option("-i,--index", input0_.index, "Index of the multigraph in the file")->default_val(0);
-    cmd->add_option("-k", k_, "Value for k in findHamiltonianKExtension")->default_val(1);
-    cmd->add_flag("--approx", approx_, "Use approximation algorithm");
+    add_k_range_option(cmd, "Value for k in findHamiltonianKExtension");
+    auto* approx = cmd->add_flag("--approx", approx_, "Use approximation algorithm");
+    cmd->add_option("-t,--threads", threads_, "Number of solver worker threads, 0 uses all hardware threads")
+        ->default_val(1);
+    cmd->add_option("--time-limit", time_limit_ms_,
+                    "Run the multi-start approximation for the given number of milliseconds")
+        ->needs(approx);
+    cmd->add_option("--seed", seed_, "Seed of the multi-start approximation")->default_val(0);
+    cmd->add_option("--flow", flow_, "Max-flow algorithm counting the cycles with --approx: dinic or push-relabel")
+        ->check(CLI::IsMember({"dinic", "push-relabel"}))
+        ->default_val("dinic");
+    cmd->add_option("--engine", engine_, "Exact solver engine: auto, held-karp or branch-and-bound")
+        ->check(CLI::IsMember({"auto", "held-karp", "branch-and-bound"}))
+        ->default_val("auto")
+        ->excludes(approx);
+    add_reorder_option(cmd);
 }
 
 void MultigraphCLI::init_find_max_cycles_command() {
     auto* cmd = app_.add_subcommand("find_max_cycles", "Find all max k-cycles of a multigraph.");
     cmd->add_option("filepath", input0_.filepath, "Path to the multigraph file")->required()->check(CLI::ExistingFile);
     cmd->add_option("-i,--index", input0_.index, "Index of the multigraph in the file")->default_val(0);
-    cmd->add_option("-k", k_, "Value for k in max cycle finding")->default_val(1);
+    add_k_range_option(cmd, "Value for k in max cycle finding");
     cmd->add_flag("--approx", approx_, "Use approximation algorithm");
+    cmd->add_option("-t,--threads", threads_, "Number of worker threads sharing the k values of a range")
+        ->default_val(1);
     cmd->add_option("-p,--print", max_print_, "Maximum amount of printed cycles")->default_val(10);
+    add_reorder_option(cmd);
+}
+
+void MultigraphCLI::add_reorder_option(CLI::App* cmd) {
+    cmd->add_option("--reorder", reorder_, "Relabel vertices before solving: none, degree, rcm or scc")
+        ->check(CLI::IsMember({"none", "degree", "rcm", "scc"}))
+        ->default_val("none");
+}
+
+void MultigraphCLI::add_k_range_option(CLI::App* cmd, const std::string& description) {
+    cmd->add_option("-k", k_range_, description + ", or a range such as 1..16 solved as one sweep")
+        ->default_val("1");
+}
+
+std::pair<std::size_t, std::size_t> MultigraphCLI::parse_k_range(const std::string& range) {
+    const auto separator = range.find("..");
+    const std::string first = range.substr(0, separator);
+    const std::string last = separator == std::string::npos ? first : range.substr(separator + 2);
+    // at most nine digits, so that every k fits the unsigned int of the cycle finder
+    auto isNumber = [](const std::string& text) {
+        return !text.empty() && text.size() <= 9 &&
+               std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); });
+    };
+    if (!isNumber(first) || !isNumber(last) || std::stoul(first) > std::stoul(last)) {
+        throw std::invalid_argument("Invalid value for k: " + range + ", expected a number or a range first..last");
+    }
+    return {std::stoul(first), std::stoul(last)};
+}
+
+void MultigraphCLI::init_generate_command() {
+    auto* cmd = app_.add_subcommand("generate", "Generate random multigraphs and save them to a file.");
+    cmd->add_option("output", output_path_, "Path of the created multigraph file")->required();
+    cmd->add_option("--family", family_, "Graph family: erdos-renyi, power-law, hamiltonian or clustered")
+        ->check(CLI::IsMember({"erdos-renyi", "power-law", "hamiltonian", "clustered"}))
+        ->default_val("erdos-renyi");
+    cmd->add_option("-n,--vertices", generatorParameters_.vertexCount, "Vertex count of every multigraph")
+        ->default_val(10);
+    cmd->add_option("-c,--count", graph_count_, "Number of generated multigraphs")->default_val(1);
+    cmd->add_option("--seed", seed_, "Seed of the random streams")->default_val(0);
+    cmd->add_option("-t,--threads", threads_, "Number of worker threads, 0 uses all hardware threads")
+        ->default_val(1);
+    cmd->add_option("-d,--density", generatorParameters_.density,
+                    "Arc probability, inside clusters for clustered graphs")
+        ->default_val(0.1);
+    cmd->add_option("-m,--max-multiplicity", generatorParameters_.maxMultiplicity, "Maximal multiplicity of an arc")
+        ->default_val(1);
+    cmd->add_option("--exponent", generatorParameters_.exponent, "Out-degree exponent of power-law graphs")
+        ->default_val(2.5);
+    cmd->add_option("-k", generatorParameters_.k, "Minimal multiplicity of the planted Hamiltonian cycle")
+        ->default_val(1);
+    cmd->add_option("--clusters", generatorParameters_.clusterCount, "Number of clusters in clustered graphs")
+        ->default_val(4);
+    cmd->add_option("--bridge-density", generatorParameters_.bridgeDensity,
+                    "Arc probability between clusters in clustered graphs")
+        ->default_val(0.01);
 }
 
 void MultigraphCLI::execute_distance() const {
     const auto multigraphs0 = load_multigraphs(input1_.filepath);
-    const auto multigraph0 = get_multigraph(input1_, multigraphs0);
+    auto multigraph0 = get_multigraph(input1_, multigraphs0);
 
-    const auto multigraph1 = (input1_.filepath == input2_.filepath)
+    auto multigraph1 = (input1_.filepath == input2_.filepath)
                                  ? get_multigraph(input2_, multigraphs0)
                                  : get_multigraph(input2_, load_multigraphs(input2_.filepath));
 
     print_multigraph(multigraph0);
     print_multigraph(multigraph1);
 
+    if (time_limit_ms_ > 0) {
+        const metric::AnytimeMetric distFun{std::chrono::milliseconds(time_limit_ms_)};
+        const auto bounds = distFun.bounds(multigraph0.multiGraph, multigraph1.multiGraph);
+        std::cout << "Distance: " << bounds.upperBound << "\n";
+        std::cout << "Lower bound: " << bounds.lowerBound << "\n";
+        std::cout << "Optimal: " << (bounds.optimal ? "yes" : "no") << "\n";
+        return;
+    }
+
     std::unique_ptr<metric::Metric> distFun;
     if (approx_) {
         distFun = std::make_unique<metric::HeuristicMetric>(countSort_);
+    } else if (assignment_) {
+        distFun = std::make_unique<metric::AssignmentMetric>();
     } else {
-        distFun = std::make_unique<metric::ExactMetric>();
+        distFun = std::make_unique<metric::ExactMetric>(threads_);
     }
 
-    std::unique_ptr<core::Multigraph> G, H;
+    std::size_t distance;
     if (constantOutDegrees_) {
-        G = std::make_unique<core::DegreeTrackingGraph>(multigraph0.multiGraph);
-        H = std::make_unique<core::DegreeTrackingGraph>(multigraph1.multiGraph);
+        const core::DegreeTrackingGraph G(std::move(multigraph0.multiGraph));
+        const core::DegreeTrackingGraph H(std::move(multigraph1.multiGraph));
+        distance = (*distFun)(G, H);
     } else {
-        G = std::make_unique<core::Multigraph>(multigraph0.multiGraph);
-        H = std::make_unique<core::Multigraph>(multigraph1.multiGraph);
+        distance = (*distFun)(multigraph0.multiGraph, multigraph1.multiGraph);
     }
-
-    std::size_t distance = (*distFun)(*G, *H);
     std::cout << "Distance: " << distance << "\n";
 }
 
+static void write_binary(std::ostream& output, std::uint64_t value) {
+    output.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void MultigraphCLI::execute_distance_matrix() const {
+    auto rows = load_all_multigraphs(input1_.filepath);
+    const auto matrix = input2_.filepath.empty()
+                            ? metric::DistanceMatrix(std::move(rows))
+                            : metric::DistanceMatrix(std::move(rows), load_all_multigraphs(input2_.filepath));
+
+    // pairs are spread over the workers, every single distance runs on one thread
+    std::unique_ptr<metric::Metric> distFun;
+    if (approx_) {
+        distFun = std::make_unique<metric::HeuristicMetric>(countSort_);
+    } else if (assignment_) {
+        distFun = std::make_unique<metric::AssignmentMetric>();
+    } else {
+        distFun = std::make_unique<metric::ExactMetric>(1);
+    }
+
+    const bool binary = format_ == "binary";
+    std::ofstream file;
+    if (output_path_ != "-") {
+        file.open(output_path_, binary ? std::ios::binary : std::ios::out);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + output_path_);
+        }
+    }
+    std::ostream& output = output_path_ != "-" ? file : std::cout;
+
+    if (nearest_ == 0) {
+        if (binary) {
+            write_binary(output, matrix.rowCount());
+            write_binary(output, matrix.columnCount());
+        }
+        matrix.compute(*distFun, threads_, [&](std::size_t, const std::vector<std::size_t>& distances) {
+            for (std::size_t column = 0; column < distances.size(); column++) {
+                if (binary) {
+                    write_binary(output, distances[column]);
+                } else {
+                    output << (column > 0 ? "," : "") << distances[column];
+                }
+            }
+            if (!binary) output << "\n";
+        });
+        return;
+    }
+
+    const auto available = matrix.symmetric() ? std::max<std::size_t>(matrix.columnCount(), 1) - 1
+                                              : matrix.columnCount();
+    if (binary) {
+        write_binary(output, matrix.rowCount());
+        write_binary(output, std::min(nearest_, available));
+    } else {
+        output << "row,column,distance\n";
+    }
+    matrix.nearest(*distFun, threads_, nearest_,
+                   [&](std::size_t row, const std::vector<std::pair<std::size_t, std::size_t>>& neighbours) {
+                       for (auto [column, distance] : neighbours) {
+                           if (binary) {
+                               write_binary(output, column);
+                               write_binary(output, distance);
+                           } else {
+                               output << row << "," << column << "," << distance << "\n";
+                           }
+                       }
+                   });
+}
+
+void MultigraphCLI::execute_nearest() const {
+    const auto query = get_multigraph(input2_, load_multigraphs(input2_.filepath));
+
+    // only metrics satisfying the triangle inequality keep the index exact
+    std::unique_ptr<metric::Metric> distFun;
+    if (approx_) {
+        distFun = std::make_unique<metric::HeuristicMetric>(countSort_);
+    } else {
+        distFun = std::make_unique<metric::ExactMetric>(1);
+    }
+
+    const metric::SimilarityIndex index(load_all_multigraphs(input1_.filepath), *distFun, threads_);
+    const auto result = app_.get_subcommand("nearest")->count("--radius") > 0
+                            ? index.within(query.multiGraph, radius_)
+                            : index.nearest(query.multiGraph, nearest_);
+
+    for (auto [graph, distance] : result.neighbours) {
+        std::cout << "Index: " << graph << ", Distance: " << distance << "\n";
+    }
+    std::cout << "Evaluated " << result.evaluations << " of " << index.size() << " distances ("
+              << index.size() - result.evaluations << " avoided), " << index.buildEvaluations()
+              << " to build the index\n";
+}
+
+static hamilton::ATSPEngine parse_engine(const std::string& engine) {
+    if (engine == "held-karp") return hamilton::ATSPEngine::HeldKarp;
+    if (engine == "branch-and-bound") return hamilton::ATSPEngine::BranchAndBound;
+    return hamilton::ATSPEngine::Auto;
+}
+
 void MultigraphCLI::execute_find_hamiltonian_extension() const {
+    const auto [kFirst, kLast] = parse_k_range(k_range_);
     const auto multigraphs = load_multigraphs(input0_.filepath);
     const auto multigraph = get_multigraph(input0_, multigraphs);
 
     print_multigraph(multigraph);
 
-    core::Multigraph extension = hamilton::findKHamiltonianExtension(k_, multigraph.multiGraph, approx_);
+    if (kFirst != kLast) {
+        execute_hamiltonian_extension_sweep(multigraph, kFirst, kLast);
+        return;
+    }
+    const std::size_t k = kFirst;
+
+    const auto strategy = reorder::parseStrategy(reorder_);
+    const auto timeLimit = std::chrono::milliseconds(time_limit_ms_);
+    const auto engine = parse_engine(engine_);
+    std::vector<std::vector<std::size_t>> extMatrix;
+    if (strategy == reorder::Strategy::None) {
+        extMatrix = hamilton::findKHamiltonianExtension(k, multigraph.multiGraph, approx_, threads_, timeLimit, seed_,
+                                                        engine);
+    } else {
+        const auto order = reorder::VertexOrder::compute(multigraph.multiGraph, strategy, k);
+        const auto reordered = order.apply(multigraph.multiGraph);
+        extMatrix = order.restoreMatrix(
+            hamilton::findKHamiltonianExtension(k, reordered, approx_, threads_, timeLimit, seed_, engine));
+    }
 
     std::size_t kExtSize = 0;
-    auto extMatrix = extension.getAdjacencyMatrix();
     std::cout << "Hamiltonian k-extension: " << std::endl;
     for (int i = 0; i < extMatrix.size(); ++i) {
         for (int j = 0; j < extMatrix.size(); ++j) {
@@ -128,28 +397,29 @@ void MultigraphCLI::execute_find_hamiltonian_extension() const {
     }
     std::cout << "Hamiltonian k-extension size: " << kExtSize << std::endl;
 
-    auto multMatrix = multigraph.multiGraph.getAdjacencyMatrix();
+    const auto multMatrix = multigraph.multiGraph.view();
+    const std::size_t n = multigraph.multiGraph.vertexCount();
 
     std::cout << "Extended input multigraph to Hamiltonian k-cycle graph: " << std::endl;
-    std::vector<std::vector<std::size_t>> extendedMatrix(multMatrix.size(),
-                                                         std::vector<std::size_t>(multMatrix.size()));
-    for (int i = 0; i < multMatrix.size(); ++i) {
-        for (int j = 0; j < multMatrix.size(); ++j) {
-            extendedMatrix[i][j] = multMatrix[i][j] + extMatrix[i][j];
-            std::cout << multMatrix[i][j] + extMatrix[i][j] << " ";
+    std::vector<std::vector<std::size_t>> extendedMatrix(n, std::vector<std::size_t>(n));
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            extendedMatrix[i][j] = multMatrix(i, j) + extMatrix[i][j];
+            std::cout << extendedMatrix[i][j] << " ";
         }
         std::cout << std::endl;
     }
 
     if (approx_) {
-        auto modifiedGraph = multigraph.multiGraph.kGraph(k_);
-        auto modifiedMatrix = modifiedGraph.getAdjacencyMatrix();
-        std::size_t maxFlow = hamilton::findAllHamiltonianCycles(modifiedMatrix, extMatrix, k_);
+        auto kGraph = core::KThresholdBitGraph(multigraph.multiGraph, k);
+        const auto algorithm =
+            flow_ == "push-relabel" ? hamilton::FlowAlgorithm::PushRelabel : hamilton::FlowAlgorithm::Dinic;
+        std::size_t maxFlow = hamilton::findAllHamiltonianCycles(kGraph, extMatrix, algorithm);
 
         std::cout << "Number of Hamilton cycles in the extended graph: " << maxFlow << std::endl;
     } else {
         core::Multigraph extendedMultiGraph(extendedMatrix);
-        cycleFinder::MaxCycle maxCycleObj(extendedMultiGraph, k_);
+        cycleFinder::MaxCycle maxCycleObj(extendedMultiGraph, k);
         maxCycleObj.solve();
         auto cycles = maxCycleObj.getMaxVertexCycles();
 
@@ -157,13 +427,59 @@ void MultigraphCLI::execute_find_hamiltonian_extension() const {
     }
 }
 
+void MultigraphCLI::execute_hamiltonian_extension_sweep(const Multigraph& multigraph, std::size_t kFirst,
+                                                        std::size_t kLast) const {
+    // one vertex order, computed for the smallest k, serves the whole sweep
+    const auto strategy = reorder::parseStrategy(reorder_);
+    const auto timeLimit = std::chrono::milliseconds(time_limit_ms_);
+    const auto engine = parse_engine(engine_);
+    std::vector<std::vector<std::vector<std::size_t>>> extensions;
+    if (strategy == reorder::Strategy::None) {
+        extensions = hamilton::findKHamiltonianExtensions(kFirst, kLast, multigraph.multiGraph, approx_, threads_,
+                                                          timeLimit, seed_, engine);
+    } else {
+        const auto order = reorder::VertexOrder::compute(multigraph.multiGraph, strategy, kFirst);
+        extensions = hamilton::findKHamiltonianExtensions(kFirst, kLast, order.apply(multigraph.multiGraph), approx_,
+                                                          threads_, timeLimit, seed_, engine);
+        for (auto& extension : extensions) {
+            extension = order.restoreMatrix(extension);
+        }
+    }
+
+    std::cout << "k,extension_size,extended_arcs\n";
+    for (std::size_t i = 0; i < extensions.size(); ++i) {
+        std::size_t size = 0, arcs = 0;
+        for (const auto& row : extensions[i]) {
+            for (std::size_t value : row) {
+                size += value;
+                arcs += value != 0;
+            }
+        }
+        std::cout << kFirst + i << "," << size << "," << arcs << "\n";
+    }
+}
+
 void MultigraphCLI::execute_find_max_cycles() const {
+    const auto [kFirst, kLast] = parse_k_range(k_range_);
     const auto multigraphs = load_multigraphs(input0_.filepath);
     const auto multigraph = get_multigraph(input0_, multigraphs);
 
     print_multigraph(multigraph);
-    auto maxCycleFinder = cycleFinder::MaxCycle(multigraph.multiGraph, k_);
+
+    if (kFirst != kLast) {
+        execute_max_cycles_sweep(multigraph, kFirst, kLast);
+        return;
+    }
+    const std::size_t k = kFirst;
+
+    const auto strategy = reorder::parseStrategy(reorder_);
+    const auto order = reorder::VertexOrder::compute(multigraph.multiGraph, strategy, k);
+    const auto reordered =
+        strategy == reorder::Strategy::None ? core::Multigraph() : order.apply(multigraph.multiGraph);
+    auto maxCycleFinder =
+        cycleFinder::MaxCycle(strategy == reorder::Strategy::None ? multigraph.multiGraph : reordered, k);
     auto cycles = approx_ ? maxCycleFinder.approximate() : maxCycleFinder.solve();
+    if (strategy != reorder::Strategy::None) cycles = order.restoreCycles(cycles);
     if (cycles.empty()) {
         std::cout << "Didn't find any cycles in this multigraph.\n";
         return;
@@ -183,6 +499,47 @@ void MultigraphCLI::execute_find_max_cycles() const {
     this->print_cycles(cycles, multigraph.multiGraph);
 }
 
+void MultigraphCLI::execute_max_cycles_sweep(const Multigraph& multigraph, std::size_t kFirst,
+                                             std::size_t kLast) const {
+    // one vertex order, computed for the smallest k, serves the whole sweep
+    const auto strategy = reorder::parseStrategy(reorder_);
+    const auto order = reorder::VertexOrder::compute(multigraph.multiGraph, strategy, kFirst);
+    const auto reordered =
+        strategy == reorder::Strategy::None ? core::Multigraph() : order.apply(multigraph.multiGraph);
+    auto results = cycleFinder::MaxCycleSolver().sweep(
+        strategy == reorder::Strategy::None ? multigraph.multiGraph : reordered, kFirst, kLast, approx_, threads_);
+
+    std::cout << "k,cycles,vertices,edges,max_out_degree\n";
+    for (const auto& result : results) {
+        std::cout << result.k << "," << result.cycles.size() << "," << result.size.vertexCount << ","
+                  << result.size.edgeCount << "," << result.size.maxOutDegree << "\n";
+    }
+}
+
+void MultigraphCLI::execute_generate() const {
+    auto parameters = generatorParameters_;
+    parameters.family = generator::parseFamily(family_);
+    generator::Generator graphGenerator(parameters, seed_, threads_);
+
+    std::ofstream file(output_path_);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + output_path_);
+    }
+
+    // one graph per worker at a time keeps memory bounded for large files
+    const std::size_t batchSize = core::resolveThreadCount(threads_);
+    file << graph_count_ << "\n";
+    for (std::size_t first = 0; first < graph_count_; first += batchSize) {
+        auto batch = graphGenerator.generate(first, std::min(batchSize, graph_count_ - first));
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            if (first + i > 0) file << "\n";
+            generator::writeMultigraph(file, batch[i]);
+        }
+    }
+
+    std::cout << "Generated " << graph_count_ << " multigraphs in " << output_path_ << "\n";
+}
+
 std::vector<AdjacencyMatrix> MultigraphCLI::parse_all_multigraphs(std::istream& input) {
     std::vector<AdjacencyMatrix> multigraphs;
     std::string line;
@@ -241,6 +598,14 @@ std::vector<AdjacencyMatrix> MultigraphCLI::load_multigraphs(const std::string&
     return parse_all_multigraphs(file);
 }
 
+std::vector<core::Multigraph> MultigraphCLI::load_all_multigraphs(const std::string& filepath) {
+    std::vector<core::Multigraph> multigraphs;
+    for (const auto& adjacencyMatrix : load_multigraphs(filepath)) {
+        multigraphs.emplace_back(adjacencyMatrix);
+    }
+    return multigraphs;
+}
+
 Multigraph MultigraphCLI::get_multigraph(const Multigraph& input, const std::vector<AdjacencyMatrix>& multigraphs) {
     if (input.index >= multigraphs.size()) {
         throw std::out_of_range("Index " + std::to_string(input.index) + " out of range for file " + input.filepath);
@@ -251,8 +616,8 @@ Multigraph MultigraphCLI::get_multigraph(const Multigraph& input, const std::vec
 
 void MultigraphCLI::print_multigraph(const Multigraph& multigraph) {
     std::cout << "Multigraph from file: " << multigraph.filepath << ", Index: " << multigraph.index << "\n";
-    for (const auto& row : multigraph.multiGraph.getAdjacencyMatrix()) {
-        for (auto value : row) {
+    for (vertex v = 0; v < multigraph.multiGraph.vertexCount(); v++) {
+        for (std::size_t value : multigraph.multiGraph.row(v)) {
             std::cout << value << " ";
         }
         std::cout << "\n";
@@ -285,9 +650,9 @@ void MultigraphCLI::print_cycle_in_multigraph(const std::vector<vertex>& cycle,
     std::cout << "Cycle represented in multigraph matrix: \n";
     std::vector<std::vector<vertex>> adjacencyMatrix(multigraph.vertexCount(),
                                                      std::vector<vertex>(multigraph.vertexCount(), 0));
-    auto multigraphAdjacencyMatrix = multigraph.getAdjacencyMatrix();
+    const auto multigraphAdjacencyMatrix = multigraph.view();
     for (int i = 0; i < cycle.size() - 1; i++) {
-        adjacencyMatrix[cycle[i]][cycle[i + 1]] = multigraphAdjacencyMatrix[cycle[i]][cycle[i + 1]];
+        adjacencyMatrix[cycle[i]][cycle[i + 1]] = multigraphAdjacencyMatrix(cycle[i], cycle[i + 1]);
     }
     for (const auto& row : adjacencyMatrix) {
         for (auto value : row) {
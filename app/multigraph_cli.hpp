@@ -10,7 +10,9 @@
 #include <sstream>
 #include <stdexcept>
 #include <filesystem>
+#include <utility>
 #include "core.hpp"
+#include "generator.hpp"
 #include <CLI/CLI.hpp>
 
 using AdjacencyMatrix = std::vector<std::vector<std::size_t>>;
@@ -33,22 +35,51 @@ class MultigraphCLI {
     Multigraph input1_{"", 0, core::Multigraph(0)};
     Multigraph input2_{"", 0, core::Multigraph(0)};
     Multigraph input0_{"", 0, core::Multigraph(0)};
-    std::size_t k_{1};
+    std::string k_range_{"1"};
     std::size_t max_print_{10};
     bool approx_{false};
+    bool assignment_{false};
     bool countSort_{false};
     bool constantOutDegrees_{false};
+    std::string reorder_{"none"};
+    std::string format_{"csv"};
+    std::string flow_{"dinic"};
+    std::string engine_{"auto"};
+    std::size_t nearest_{0};
+    std::size_t radius_{0};
+    std::string output_path_;
+    std::string family_{"erdos-renyi"};
+    generator::GeneratorParameters generatorParameters_;
+    std::size_t graph_count_{1};
+    std::uint64_t seed_{0};
+    unsigned int threads_{1};
+    std::size_t time_limit_ms_{0};
 
     void init_distance_command();
+    void init_distance_matrix_command();
+    void init_nearest_command();
     void init_find_hamiltonian_extension_command();
     void init_find_max_cycles_command();
+    void init_generate_command();
 
     void execute_distance() const;
+    void execute_distance_matrix() const;
+    void execute_nearest() const;
     void execute_find_hamiltonian_extension() const;
     void execute_find_max_cycles() const;
+    void execute_generate() const;
+
+    void add_reorder_option(CLI::App* cmd);
+    void add_k_range_option(CLI::App* cmd, const std::string& description);
+    // first and last k of a single value or of a range written as first..last
+    static std::pair<std::size_t, std::size_t> parse_k_range(const std::string& range);
+    void execute_hamiltonian_extension_sweep(const Multigraph& multigraph, std::size_t kFirst,
+                                             std::size_t kLast) const;
+    void execute_max_cycles_sweep(const Multigraph& multigraph, std::size_t kFirst, std::size_t kLast) const;
 
     static std::vector<AdjacencyMatrix> parse_all_multigraphs(std::istream& input);
     static std::vector<AdjacencyMatrix> load_multigraphs(const std::string& filepath);
+    static std::vector<core::Multigraph> load_all_multigraphs(const std::string& filepath);
     static Multigraph get_multigraph(const Multigraph& input, const std::vector<AdjacencyMatrix>& multigraphs);
     static void print_multigraph(const Multigraph& multigraph);
     void print_cycles(const std::vector<std::vector<vertex>>& cycles, const core::Multigraph& multigraph) const;
@@ -0,0 +1,180 @@
+#include "bit_graph.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TAIO_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace core
+{
+
+// Packs (counts[v] >= threshold) for v < size into consecutive bits of out.
+static void thresholdRowScalar(const multiplicity* counts, std::size_t size, multiplicity threshold, word* out) {
+    for (std::size_t w = 0; w * WORD_BITS < size; w++) {
+        word bits = 0;
+        std::size_t end = std::min(size, (w + 1) * WORD_BITS);
+        for (std::size_t v = w * WORD_BITS; v < end; v++) {
+            bits |= static_cast<word>(counts[v] >= threshold) << (v % WORD_BITS);
+        }
+        out[w] = bits;
+    }
+}
+
+#ifdef TAIO_AVX2_DISPATCH
+// Compares 64 consecutive counts against the threshold and returns the result as one word.
+__attribute__((target("avx2"))) static word thresholdWordAvx2(const multiplicity* counts, __m256i threshold) {
+    word bits = 0;
+    if constexpr (sizeof(multiplicity) == 1) {
+        for (std::size_t i = 0; i < 2; i++) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts + 32 * i));
+            auto ge = _mm256_cmpeq_epi8(_mm256_max_epu8(x, threshold), x);
+            bits |= static_cast<word>(static_cast<std::uint32_t>(_mm256_movemask_epi8(ge))) << (32 * i);
+        }
+    } else if constexpr (sizeof(multiplicity) == 2) {
+        for (std::size_t i = 0; i < 2; i++) {
+            auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts + 32 * i));
+            auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts + 32 * i + 16));
+            auto geA = _mm256_cmpeq_epi16(_mm256_max_epu16(a, threshold), a);
+            auto geB = _mm256_cmpeq_epi16(_mm256_max_epu16(b, threshold), b);
+            // packing interleaves 128-bit lanes, the permutation restores the element order
+            auto packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(geA, geB), 0xD8);
+            bits |= static_cast<word>(static_cast<std::uint32_t>(_mm256_movemask_epi8(packed))) << (32 * i);
+        }
+    } else if constexpr (sizeof(multiplicity) == 4) {
+        for (std::size_t i = 0; i < 8; i++) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts + 8 * i));
+            auto ge = _mm256_cmpeq_epi32(_mm256_max_epu32(x, threshold), x);
+            bits |= static_cast<word>(_mm256_movemask_ps(_mm256_castsi256_ps(ge))) << (8 * i);
+        }
+    } else {
+        // AVX2 has no unsigned 64-bit compare, flipping the sign bit maps it onto the signed one
+        const auto sign = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+        const auto biasedThreshold = _mm256_xor_si256(threshold, sign);
+        for (std::size_t i = 0; i < 16; i++) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts + 4 * i));
+            auto lt = _mm256_cmpgt_epi64(biasedThreshold, _mm256_xor_si256(x, sign));
+            bits |= static_cast<word>(~_mm256_movemask_pd(_mm256_castsi256_pd(lt)) & 0xF) << (4 * i);
+        }
+    }
+    return bits;
+}
+
+__attribute__((target("avx2"))) static void thresholdRowAvx2(const multiplicity* counts, std::size_t size,
+                                                             multiplicity threshold, word* out) {
+    __m256i broadcast;
+    if constexpr (sizeof(multiplicity) == 1) {
+        broadcast = _mm256_set1_epi8(static_cast<char>(threshold));
+    } else if constexpr (sizeof(multiplicity) == 2) {
+        broadcast = _mm256_set1_epi16(static_cast<short>(threshold));
+    } else if constexpr (sizeof(multiplicity) == 4) {
+        broadcast = _mm256_set1_epi32(static_cast<int>(threshold));
+    } else {
+        broadcast = _mm256_set1_epi64x(static_cast<long long>(threshold));
+    }
+
+    std::size_t fullWords = size / WORD_BITS;
+    for (std::size_t w = 0; w < fullWords; w++) {
+        out[w] = thresholdWordAvx2(counts + w * WORD_BITS, broadcast);
+    }
+    if (size % WORD_BITS != 0) {
+        thresholdRowScalar(counts + fullWords * WORD_BITS, size % WORD_BITS, threshold, out + fullWords);
+    }
+}
+#endif
+
+static void thresholdRow(const multiplicity* counts, std::size_t size, multiplicity threshold, word* out) {
+#ifdef TAIO_AVX2_DISPATCH
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) return thresholdRowAvx2(counts, size, threshold, out);
+#endif
+    thresholdRowScalar(counts, size, threshold, out);
+}
+
+KThresholdBitGraph::KThresholdBitGraph() {
+}
+
+KThresholdBitGraph::KThresholdBitGraph(std::size_t size)
+    : _vertexCount(size), _wordsPerRow((size + WORD_BITS - 1) / WORD_BITS), _bits(size * _wordsPerRow, 0) {
+}
+
+KThresholdBitGraph::KThresholdBitGraph(const core::Multigraph& multigraph, unsigned int k)
+    : KThresholdBitGraph(multigraph.vertexCount()) {
+    // a k-graph never keeps empty entries, even for k = 0
+    std::size_t threshold = std::max(k, 1U);
+    if (threshold > std::numeric_limits<multiplicity>::max()) return;
+
+    for (vertex v = 0; v < _vertexCount; v++) {
+        thresholdRow(multigraph.row(v).data(), _vertexCount, static_cast<multiplicity>(threshold), rowData(v));
+    }
+}
+
+std::size_t KThresholdBitGraph::vertexCount() const {
+    return _vertexCount;
+}
+
+std::size_t KThresholdBitGraph::wordsPerRow() const {
+    return _wordsPerRow;
+}
+
+std::size_t KThresholdBitGraph::arcCount() const {
+    std::size_t count = 0;
+    for (auto bits : _bits) {
+        count += std::popcount(bits);
+    }
+    return count;
+}
+
+std::size_t KThresholdBitGraph::outArcCount(vertex v) const {
+    std::size_t count = 0;
+    for (auto bits : row(v)) {
+        count += std::popcount(bits);
+    }
+    return count;
+}
+
+std::size_t KThresholdBitGraph::commonOutNeighbourCount(vertex u, vertex v) const {
+    std::size_t count = 0;
+    for (std::size_t w = 0; w < _wordsPerRow; w++) {
+        count += std::popcount(rowData(u)[w] & rowData(v)[w]);
+    }
+    return count;
+}
+
+bool KThresholdBitGraph::hasEdge(vertex u, vertex v) const {
+    return (rowData(u)[v / WORD_BITS] >> (v % WORD_BITS)) & 1;
+}
+
+void KThresholdBitGraph::addEdge(vertex u, vertex v) {
+    rowData(u)[v / WORD_BITS] |= word(1) << (v % WORD_BITS);
+}
+
+void KThresholdBitGraph::removeAllEdges(vertex v) {
+    std::fill_n(rowData(v), _wordsPerRow, 0);
+    const word mask = ~(word(1) << (v % WORD_BITS));
+    for (vertex u = 0; u < _vertexCount; u++) {
+        rowData(u)[v / WORD_BITS] &= mask;
+    }
+}
+
+std::span<const word> KThresholdBitGraph::row(vertex v) const {
+    return std::span<const word>(rowData(v), _wordsPerRow);
+}
+
+BitNeighbourRange KThresholdBitGraph::neighbours(vertex v) const {
+    return BitNeighbourRange(rowData(v), _wordsPerRow);
+}
+
+KThresholdBitGraph KThresholdBitGraph::inducedSubgraph(const std::vector<vertex>& vertices) const {
+    auto G = KThresholdBitGraph(vertices.size());
+    for (vertex v = 0; v < vertices.size(); v++) {
+        for (vertex u = 0; u < vertices.size(); u++) {
+            if (hasEdge(vertices[v], vertices[u])) G.addEdge(v, u);
+        }
+    }
+    return G;
+}
+
+} // namespace core
@@ -1,6 +1,11 @@
 #include "core.hpp"
 #include <vector>
 #include <numeric>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <stdlib.h>
 
 namespace core
@@ -9,55 +14,102 @@ namespace core
 Multigraph::Multigraph() {
 }
 
-Multigraph::Multigraph(const std::vector<std::vector<std::size_t>>& adjacencyMatrix) {
-    this->adjacencyMatrix = adjacencyMatrix;
+Multigraph::Multigraph(const std::vector<std::vector<std::size_t>>& adjacencyMatrix)
+    : _vertexCount(adjacencyMatrix.size()), adjacencyMatrix(adjacencyMatrix.size() * adjacencyMatrix.size()) {
+    for (vertex u = 0; u < _vertexCount; u++) {
+        if (adjacencyMatrix[u].size() != _vertexCount) {
+            throw std::invalid_argument("Adjacency matrix must be square");
+        }
+        for (vertex v = 0; v < _vertexCount; v++) {
+            if (adjacencyMatrix[u][v] > std::numeric_limits<multiplicity>::max()) {
+                throw std::out_of_range("Edge multiplicity " + std::to_string(adjacencyMatrix[u][v]) +
+                                        " does not fit in " + std::to_string(TAIO_MULTIPLICITY_BITS) + " bits");
+            }
+            this->adjacencyMatrix[index(u, v)] = static_cast<multiplicity>(adjacencyMatrix[u][v]);
+        }
+    }
+}
+
+Multigraph::Multigraph(std::size_t size, std::vector<multiplicity>&& adjacencyMatrix)
+    : _vertexCount(size), adjacencyMatrix(std::move(adjacencyMatrix)) {
+    if (this->adjacencyMatrix.size() != size * size) {
+        throw std::invalid_argument("Adjacency matrix must be square");
+    }
+}
+
+Multigraph::Multigraph(const core::Multigraph& multiGraph)
+    : _vertexCount(multiGraph._vertexCount), adjacencyMatrix(multiGraph.adjacencyMatrix) {
+}
+
+Multigraph::Multigraph(core::Multigraph&& multiGraph) noexcept
+    : _vertexCount(std::exchange(multiGraph._vertexCount, 0)),
+      adjacencyMatrix(std::move(multiGraph.adjacencyMatrix)) {
+}
+
+Multigraph& Multigraph::operator=(const core::Multigraph& multiGraph) {
+    _vertexCount = multiGraph._vertexCount;
+    adjacencyMatrix = multiGraph.adjacencyMatrix;
+    return *this;
 }
 
-Multigraph::Multigraph(const core::Multigraph& multiGraph) {
-    this->adjacencyMatrix = multiGraph.adjacencyMatrix;
+Multigraph& Multigraph::operator=(core::Multigraph&& multiGraph) noexcept {
+    _vertexCount = std::exchange(multiGraph._vertexCount, 0);
+    adjacencyMatrix = std::move(multiGraph.adjacencyMatrix);
+    return *this;
 }
+
 std::size_t Multigraph::vertexCount() const {
-    return this->adjacencyMatrix.size();
+    return _vertexCount;
 }
 
 Size Multigraph::size() const {
     std::size_t edgeCount = 0;
     std::size_t maxDegree = 0;
-    for (const auto& row : adjacencyMatrix) {
-        for (const auto& edges : row) {
-            edgeCount += edges;
-            maxDegree = maxDegree > edges ? maxDegree : edges;
-        }
+    for (const auto edges : adjacencyMatrix) {
+        edgeCount += edges;
+        maxDegree = maxDegree > edges ? maxDegree : edges;
     };
-    return Size{adjacencyMatrix.size(), edgeCount, maxDegree};
+    return Size{_vertexCount, edgeCount, maxDegree};
 }
 
 std::vector<vertex> Multigraph::getNeighbours(vertex v) const {
-    std::vector<vertex> neighbours;
-    for (int i = 0; i < this->adjacencyMatrix[v].size(); i++) {
-        if (this->adjacencyMatrix[v][i] > 0) neighbours.push_back(i);
-    }
-    return neighbours;
+    auto range = neighbours(v);
+    return std::vector<vertex>(range.begin(), range.end());
+}
+
+NeighbourRange Multigraph::neighbours(vertex v) const {
+    return NeighbourRange(adjacencyMatrix.data() + index(v, 0), _vertexCount);
 }
 
-Multigraph::Multigraph(std::size_t size) : adjacencyMatrix(size, std::vector<vertex>(size, 0)) {
+std::span<const multiplicity> Multigraph::row(vertex v) const {
+    return std::span<const multiplicity>(adjacencyMatrix.data() + index(v, 0), _vertexCount);
+}
+
+AdjacencyView Multigraph::view() const {
+    return AdjacencyView(adjacencyMatrix.data(), _vertexCount);
+}
+
+Multigraph::Multigraph(std::size_t size) : _vertexCount(size), adjacencyMatrix(size * size, 0) {
 }
 
 void Multigraph::addEdge(vertex u, vertex v) {
-    this->adjacencyMatrix[u][v] = this->adjacencyMatrix[u][v] + 1;
+    auto& edges = this->adjacencyMatrix[index(u, v)];
+    if (edges == std::numeric_limits<multiplicity>::max()) {
+        throw std::overflow_error("Edge multiplicity does not fit in " + std::to_string(TAIO_MULTIPLICITY_BITS) +
+                                  " bits");
+    }
+    edges++;
 }
 
 bool Multigraph::hasEdge(vertex u, vertex v) const {
-    return this->adjacencyMatrix[u][v] > 0;
+    return this->adjacencyMatrix[index(u, v)] > 0;
 }
 
 Multigraph Multigraph::inducedSubgraph(const std::vector<vertex>& vertices) const {
     auto G = Multigraph(vertices.size());
     for (vertex v = 0; v < vertices.size(); v++) {
         for (vertex u = 0; u < vertices.size(); u++) {
-            for (int i = 0; i < adjacencyMatrix[vertices[v]][vertices[u]]; i++) {
-                G.addEdge(v, u);
-            }
+            G.adjacencyMatrix[G.index(v, u)] = adjacencyMatrix[index(vertices[v], vertices[u])];
         }
     }
     return G;
@@ -66,41 +118,69 @@ Multigraph Multigraph::inducedSubgraph(const std::vector<vertex>& vertices) cons
 Multigraph Multigraph::cycleGraph(const std::vector<vertex>& vertices) const {
     auto G = Multigraph(vertices.size() - 1);
     for (vertex v = 1; v < vertices.size() - 1; v++) {
-        G.adjacencyMatrix[v - 1][v] = adjacencyMatrix[vertices[v - 1]][vertices[v]];
+        G.adjacencyMatrix[G.index(v - 1, v)] = adjacencyMatrix[index(vertices[v - 1], vertices[v])];
     }
 
     // add last edge
-    G.adjacencyMatrix[vertices.size() - 2][0] = adjacencyMatrix[vertices[vertices.size() - 2]][vertices[0]];
+    G.adjacencyMatrix[G.index(vertices.size() - 2, 0)] =
+        adjacencyMatrix[index(vertices[vertices.size() - 2], vertices[0])];
     return G;
 }
 
+Size Multigraph::cycleSize(const std::vector<vertex>& vertices) const {
+    std::size_t edgeCount = 0;
+    std::size_t maxDegree = 0;
+    for (vertex v = 1; v < vertices.size(); v++) {
+        std::size_t edges = adjacencyMatrix[index(vertices[v - 1], vertices[v])];
+        edgeCount += edges;
+        maxDegree = maxDegree > edges ? maxDegree : edges;
+    }
+    return Size{vertices.size() - 1, edgeCount, maxDegree};
+}
+
 void Multigraph::removeAllEdges(vertex v) {
-    for (vertex u = 0; u < this->vertexCount(); u++) {
-        adjacencyMatrix[v][u] = adjacencyMatrix[u][v] = 0;
+    std::fill_n(adjacencyMatrix.begin() + index(v, 0), _vertexCount, 0);
+    for (vertex u = 0; u < _vertexCount; u++) {
+        adjacencyMatrix[index(u, v)] = 0;
     }
 }
 
 Multigraph Multigraph::kGraph(unsigned int k) const {
-
     Multigraph G = Multigraph(*this);
-    for (vertex v = 0; v < G.vertexCount(); v++) {
-        for (vertex u = 0; u < G.vertexCount(); u++) {
-            if (G.adjacencyMatrix[v][u] < k) G.adjacencyMatrix[v][u] = 0;
-        }
+    for (auto& edges : G.adjacencyMatrix) {
+        if (edges < k) edges = 0;
     }
     return G;
 }
 
 std::vector<std::vector<std::size_t>> Multigraph::getAdjacencyMatrix() const {
-    return this->adjacencyMatrix;
+    std::vector<std::vector<std::size_t>> matrix(_vertexCount);
+    for (vertex v = 0; v < _vertexCount; v++) {
+        auto row = adjacencyMatrix.begin() + index(v, 0);
+        matrix[v].assign(row, row + _vertexCount);
+    }
+    return matrix;
 }
 
 std::size_t Multigraph::edgeCount(std::size_t from, std::size_t to) const {
-    return adjacencyMatrix[from][to];
+    return adjacencyMatrix[index(from, to)];
+}
+
+std::size_t Multigraph::inDegree(std::size_t vertex) const {
+    std::size_t degree = 0;
+    for (std::size_t u = 0; u < _vertexCount; u++) {
+        degree += adjacencyMatrix[index(u, vertex)];
+    }
+    return degree;
+}
+
+std::size_t Multigraph::arcCount() const {
+    return adjacencyMatrix.size() - std::count(adjacencyMatrix.begin(), adjacencyMatrix.end(), 0);
 }
 
 std::size_t Multigraph::outDegree(std::size_t vertex) const {
-    return std::accumulate(adjacencyMatrix[vertex].begin(), adjacencyMatrix[vertex].end(), (std::size_t)0);
+    auto row = adjacencyMatrix.begin() + index(vertex, 0);
+    return std::accumulate(row, row + _vertexCount, (std::size_t)0);
 }
 
 Multigraph Multigraph::random(std::size_t vertexCount, std::size_t edgeCount) {
@@ -117,35 +197,75 @@ Multigraph Multigraph::random(std::size_t vertexCount, std::size_t edgeCount) {
     return graph;
 }
 
-DegreeTrackingGraph::DegreeTrackingGraph(std::size_t size) : Multigraph(size), _outDegrees(size) {
-    computeOutDegrees();
+StatisticsTrackingGraph::StatisticsTrackingGraph(std::size_t size) : Multigraph(size) {
+    computeStatistics();
+}
+StatisticsTrackingGraph::StatisticsTrackingGraph(const core::Multigraph& multigraph) : Multigraph(multigraph) {
+    computeStatistics();
 }
-DegreeTrackingGraph::DegreeTrackingGraph(const core::Multigraph& multigraph)
-    : Multigraph(multigraph), _outDegrees(multigraph.vertexCount()) {
-    computeOutDegrees();
+StatisticsTrackingGraph::StatisticsTrackingGraph(core::Multigraph&& multigraph) : Multigraph(std::move(multigraph)) {
+    computeStatistics();
 }
-DegreeTrackingGraph::DegreeTrackingGraph(const std::vector<std::vector<std::size_t>>& adjacencyMatrix)
-    : Multigraph(adjacencyMatrix), _outDegrees(adjacencyMatrix.size()) {
-    computeOutDegrees();
+StatisticsTrackingGraph::StatisticsTrackingGraph(const std::vector<std::vector<std::size_t>>& adjacencyMatrix)
+    : Multigraph(adjacencyMatrix) {
+    computeStatistics();
 }
 
-void DegreeTrackingGraph::computeOutDegrees() {
-    for (std::size_t v = 0; v < vertexCount(); v++) {
-        _outDegrees[v] = Multigraph::outDegree(v);
+void StatisticsTrackingGraph::computeStatistics() {
+    _outDegrees.assign(vertexCount(), 0);
+    _inDegrees.assign(vertexCount(), 0);
+    _edgeCount = 0;
+    _multiplicityCounts.clear();
+    for (vertex u = 0; u < vertexCount(); u++) {
+        for (vertex v = 0; v < vertexCount(); v++) {
+            auto edges = edgeCount(u, v);
+            if (edges == 0) continue;
+            _outDegrees[u] += edges;
+            _inDegrees[v] += edges;
+            _edgeCount += edges;
+            _multiplicityCounts[edges]++;
+        }
     }
 }
 
-void DegreeTrackingGraph::addEdge(vertex u, vertex v) {
+void StatisticsTrackingGraph::removeEdges(vertex u, vertex v) {
+    auto edges = edgeCount(u, v);
+    if (edges == 0) return;
+    _outDegrees[u] -= edges;
+    _inDegrees[v] -= edges;
+    _edgeCount -= edges;
+    if (--_multiplicityCounts[edges] == 0) _multiplicityCounts.erase(edges);
+}
+
+void StatisticsTrackingGraph::addEdge(vertex u, vertex v) {
+    auto edges = edgeCount(u, v);
     Multigraph::addEdge(u, v);
     _outDegrees[u]++;
+    _inDegrees[v]++;
+    _edgeCount++;
+    if (edges > 0 && --_multiplicityCounts[edges] == 0) _multiplicityCounts.erase(edges);
+    _multiplicityCounts[edges + 1]++;
 }
-void DegreeTrackingGraph::removeAllEdges(vertex v) {
+
+void StatisticsTrackingGraph::removeAllEdges(vertex v) {
+    for (vertex u = 0; u < vertexCount(); u++) {
+        removeEdges(v, u);
+        if (u != v) removeEdges(u, v);
+    }
     Multigraph::removeAllEdges(v);
-    _outDegrees[v] = 0;
 }
 
-std::size_t DegreeTrackingGraph::outDegree(std::size_t vertex) const {
+std::size_t StatisticsTrackingGraph::outDegree(std::size_t vertex) const {
     return _outDegrees[vertex];
 }
 
+std::size_t StatisticsTrackingGraph::inDegree(std::size_t vertex) const {
+    return _inDegrees[vertex];
+}
+
+Size StatisticsTrackingGraph::size() const {
+    std::size_t maxMultiplicity = _multiplicityCounts.empty() ? 0 : _multiplicityCounts.rbegin()->first;
+    return Size{vertexCount(), _edgeCount, maxMultiplicity};
+}
+
 } // namespace core
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "core.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+namespace core
+{
+typedef std::uint64_t word;
+const std::size_t WORD_BITS = 64;
+
+// Allocation-free range over the set bits of a row of 64-bit words, walked with count-trailing-zeros.
+class BitNeighbourRange {
+  public:
+    class iterator {
+      private:
+        const word* _words = nullptr;
+        std::size_t _wordCount = 0;
+        std::size_t _wordIndex = 0;
+        word _current = 0;
+
+        void skipEmpty() {
+            while (_current == 0 && _wordIndex < _wordCount) {
+                if (++_wordIndex < _wordCount) _current = _words[_wordIndex];
+            }
+        }
+
+      public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = vertex;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const vertex*;
+        using reference = vertex;
+
+        iterator() = default;
+        iterator(const word* words, std::size_t wordCount, std::size_t wordIndex)
+            : _words(words), _wordCount(wordCount), _wordIndex(wordIndex),
+              _current(wordIndex < wordCount ? words[wordIndex] : 0) {
+            skipEmpty();
+        }
+
+        vertex operator*() const {
+            return _wordIndex * WORD_BITS + std::countr_zero(_current);
+        }
+        iterator& operator++() {
+            _current &= _current - 1;
+            skipEmpty();
+            return *this;
+        }
+        iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+        bool operator==(const iterator& other) const {
+            return _wordIndex == other._wordIndex && _current == other._current;
+        }
+    };
+
+    BitNeighbourRange(const word* words, std::size_t wordCount) : _words(words), _wordCount(wordCount) {
+    }
+
+    iterator begin() const {
+        return iterator(_words, _wordCount, 0);
+    }
+    iterator end() const {
+        return iterator(_words, _wordCount, _wordCount);
+    }
+
+  private:
+    const word* _words;
+    std::size_t _wordCount;
+};
+
+// Structure of the k-graph of a multigraph packed one bit per (u, v) pair: bit v of row u is set iff the multigraph
+// has at least k edges from u to v. Rows are padded to whole words so they can be intersected word by word.
+class KThresholdBitGraph {
+  private:
+    std::size_t _vertexCount = 0;
+    std::size_t _wordsPerRow = 0;
+    std::vector<word> _bits;
+
+    word* rowData(vertex v) {
+        return _bits.data() + v * _wordsPerRow;
+    }
+    const word* rowData(vertex v) const {
+        return _bits.data() + v * _wordsPerRow;
+    }
+
+  public:
+    KThresholdBitGraph();
+    KThresholdBitGraph(std::size_t size);
+    KThresholdBitGraph(const core::Multigraph& multigraph, unsigned int k);
+
+    std::size_t vertexCount() const;
+    std::size_t wordsPerRow() const;
+    std::size_t arcCount() const;
+    std::size_t outArcCount(vertex v) const;
+    std::size_t commonOutNeighbourCount(vertex u, vertex v) const;
+
+    bool hasEdge(vertex u, vertex v) const;
+    void addEdge(vertex u, vertex v);
+    void removeAllEdges(vertex v);
+    std::span<const word> row(vertex v) const;
+    BitNeighbourRange neighbours(vertex v) const;
+    KThresholdBitGraph inducedSubgraph(const std::vector<vertex>& vertices) const;
+};
+
+} // namespace core
@@ -1,12 +1,33 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <span>
 #include <vector>
 
+// Width in bits of a stored edge multiplicity, configured through the TAIO_MULTIPLICITY_BITS CMake cache variable.
+#ifndef TAIO_MULTIPLICITY_BITS
+#define TAIO_MULTIPLICITY_BITS 32
+#endif
+
 typedef std::size_t vertex;
 
 namespace core
 {
+#if TAIO_MULTIPLICITY_BITS == 8
+typedef std::uint8_t multiplicity;
+#elif TAIO_MULTIPLICITY_BITS == 16
+typedef std::uint16_t multiplicity;
+#elif TAIO_MULTIPLICITY_BITS == 32
+typedef std::uint32_t multiplicity;
+#elif TAIO_MULTIPLICITY_BITS == 64
+typedef std::size_t multiplicity;
+#else
+#error "TAIO_MULTIPLICITY_BITS must be one of 8, 16, 32 or 64"
+#endif
+
 struct Size {
   public:
     std::size_t vertexCount;
@@ -28,46 +49,165 @@ struct Size {
     }
 };
 
+// Allocation-free range over the non-zero entries of one dense adjacency matrix row.
+class NeighbourRange {
+  public:
+    class iterator {
+      private:
+        const multiplicity* _row = nullptr;
+        std::size_t _size = 0;
+        vertex _current = 0;
+
+        void skipEmpty() {
+            while (_current < _size && _row[_current] == 0)
+                _current++;
+        }
+
+      public:
+        // operator* yields a vertex by value, so only the C++20 concept can be forward
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = vertex;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const vertex*;
+        using reference = vertex;
+
+        iterator() = default;
+        iterator(const multiplicity* row, std::size_t size, vertex current)
+            : _row(row), _size(size), _current(current) {
+            skipEmpty();
+        }
+
+        vertex operator*() const {
+            return _current;
+        }
+        iterator& operator++() {
+            _current++;
+            skipEmpty();
+            return *this;
+        }
+        iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+        bool operator==(const iterator& other) const {
+            return _current == other._current;
+        }
+    };
+
+    NeighbourRange(const multiplicity* row, std::size_t size) : _row(row), _size(size) {
+    }
+
+    iterator begin() const {
+        return iterator(_row, _size, 0);
+    }
+    iterator end() const {
+        return iterator(_row, _size, _size);
+    }
+
+  private:
+    const multiplicity* _row;
+    std::size_t _size;
+};
+
+// Read-only mdspan-style view of a row-major vertexCount x vertexCount adjacency matrix. It does not own the data and
+// is invalidated by any modification of the viewed graph.
+class AdjacencyView {
+  private:
+    const multiplicity* _data;
+    std::size_t _extent;
+
+  public:
+    AdjacencyView(const multiplicity* data, std::size_t extent) : _data(data), _extent(extent) {
+    }
+
+    std::size_t operator()(vertex u, vertex v) const {
+        return _data[u * _extent + v];
+    }
+    std::size_t extent(std::size_t) const {
+        return _extent;
+    }
+    std::span<const multiplicity> row(vertex v) const {
+        return std::span<const multiplicity>(_data + v * _extent, _extent);
+    }
+    const multiplicity* data_handle() const {
+        return _data;
+    }
+};
+
 class Multigraph {
   private:
-    std::vector<std::vector<std::size_t>> adjacencyMatrix;
+    std::size_t _vertexCount = 0;
+    // row-major vertexCount x vertexCount matrix of edge multiplicities
+    std::vector<multiplicity> adjacencyMatrix;
+
+    std::size_t index(vertex u, vertex v) const {
+        return u * _vertexCount + v;
+    }
 
   public:
     Multigraph();
     Multigraph(std::size_t size);
     Multigraph(const core::Multigraph& Multigraph);
+    Multigraph(core::Multigraph&& Multigraph) noexcept;
     Multigraph(const std::vector<std::vector<std::size_t>>& adjacencyMatrix);
+    // takes ownership of a row-major size x size multiplicity buffer
+    Multigraph(std::size_t size, std::vector<multiplicity>&& adjacencyMatrix);
+    virtual ~Multigraph() = default;
+
+    Multigraph& operator=(const core::Multigraph& multiGraph);
+    Multigraph& operator=(core::Multigraph&& multiGraph) noexcept;
 
     std::size_t vertexCount() const;
     std::size_t edgeCount(std::size_t from, std::size_t to) const;
+    std::size_t arcCount() const;
     virtual std::size_t outDegree(std::size_t vertex) const;
+    virtual std::size_t inDegree(std::size_t vertex) const;
 
-    Size size() const;
+    virtual Size size() const;
     bool hasEdge(vertex u, vertex v) const;
     virtual void addEdge(vertex u, vertex v);
     virtual void removeAllEdges(vertex v);
     std::vector<vertex> getNeighbours(vertex v) const;
+    NeighbourRange neighbours(vertex v) const;
+    std::span<const multiplicity> row(vertex v) const;
+    AdjacencyView view() const;
     Multigraph inducedSubgraph(const std::vector<vertex>& vertices) const;
     Multigraph cycleGraph(const std::vector<vertex>& vertices) const;
+    // equal to cycleGraph(vertices).size() without building the cycle graph
+    Size cycleSize(const std::vector<vertex>& vertices) const;
     Multigraph kGraph(unsigned int k) const;
     static Multigraph random(std::size_t vertexCount, std::size_t edgeCount);
+    // deep copy in nested vector form, prefer view() for read-only access
     std::vector<std::vector<std::size_t>> getAdjacencyMatrix() const;
 };
 
-class DegreeTrackingGraph : public Multigraph {
-    const std::size_t DEGREE_UNDEFINED = -1;
+// Multigraph keeping its in/out-degrees, total edge count and maximal multiplicity up to date under addEdge and
+// removeAllEdges, so that outDegree, inDegree and size are O(1).
+class StatisticsTrackingGraph : public Multigraph {
     std::vector<std::size_t> _outDegrees;
+    std::vector<std::size_t> _inDegrees;
+    std::size_t _edgeCount = 0;
+    // number of vertex pairs joined by exactly m > 0 edges, its largest key is the maximal multiplicity
+    std::map<std::size_t, std::size_t> _multiplicityCounts;
 
-    void computeOutDegrees();
+    void computeStatistics();
+    void removeEdges(vertex u, vertex v);
 
   public:
-    DegreeTrackingGraph(std::size_t size);
-    DegreeTrackingGraph(const core::Multigraph& Multigraph);
-    DegreeTrackingGraph(const std::vector<std::vector<std::size_t>>& adjacencyMatrix);
+    StatisticsTrackingGraph(std::size_t size);
+    StatisticsTrackingGraph(const core::Multigraph& Multigraph);
+    StatisticsTrackingGraph(core::Multigraph&& Multigraph);
+    StatisticsTrackingGraph(const std::vector<std::vector<std::size_t>>& adjacencyMatrix);
 
     void addEdge(vertex u, vertex v) override;
     void removeAllEdges(vertex v) override;
     std::size_t outDegree(std::size_t vertex) const override;
+    std::size_t inDegree(std::size_t vertex) const override;
+    Size size() const override;
 };
 
+typedef StatisticsTrackingGraph DegreeTrackingGraph;
+
 } // namespace core
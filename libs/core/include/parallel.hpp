@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core
+{
+// Resolves a requested worker count, 0 meaning one worker per hardware thread.
+inline unsigned int resolveThreadCount(unsigned int threads) {
+    if (threads != 0) return threads;
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+// Calls body(i) for every i in [0, count) on up to `threads` workers. Workers claim chunks of indices from a shared
+// counter, so uneven iterations balance out. The first exception thrown by body is rethrown in the caller.
+template <typename Body> void parallelFor(std::size_t count, unsigned int threads, Body&& body, std::size_t chunk = 1) {
+    std::size_t chunkCount = (count + chunk - 1) / chunk;
+    threads = static_cast<unsigned int>(std::min<std::size_t>(resolveThreadCount(threads), chunkCount));
+    if (threads <= 1) {
+        for (std::size_t i = 0; i < count; i++)
+            body(i);
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker = [&]() {
+        try {
+            for (std::size_t begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk)) {
+                for (std::size_t i = begin; i < std::min(count, begin + chunk); i++)
+                    body(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+            next = count;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; t++)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& thread : workers)
+        thread.join();
+
+    if (error) std::rethrow_exception(error);
+}
+} // namespace core
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core.hpp"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace core
+{
+// Above this fraction of non-zero adjacency matrix entries the dense layout is the cheaper one.
+const double SPARSE_DENSITY_THRESHOLD = 0.125;
+
+// Multigraph in compressed sparse row (CSR) layout. Row v lists the out-neighbours of v in increasing order together
+// with the multiplicities of the corresponding edges, so neighbour iteration costs O(outDegree) and never allocates.
+class SparseMultigraph {
+  private:
+    std::vector<std::size_t> _rowOffsets;
+    std::vector<vertex> _columns;
+    std::vector<multiplicity> _multiplicities;
+
+    std::size_t find(vertex u, vertex v) const;
+
+  public:
+    SparseMultigraph();
+    SparseMultigraph(const core::Multigraph& multigraph, unsigned int k = 1);
+
+    std::size_t vertexCount() const;
+    std::size_t arcCount() const;
+    std::size_t edgeCount(std::size_t from, std::size_t to) const;
+    std::size_t outDegree(std::size_t vertex) const;
+
+    Size size() const;
+    bool hasEdge(vertex u, vertex v) const;
+    void removeAllEdges(vertex v);
+    std::span<const vertex> neighbours(vertex v) const;
+    std::span<const multiplicity> multiplicities(vertex v) const;
+    SparseMultigraph inducedSubgraph(const std::vector<vertex>& vertices) const;
+    SparseMultigraph kGraph(unsigned int k) const;
+    Multigraph toMultigraph() const;
+};
+
+// Whether a graph with the given number of distinct arcs is cheaper to traverse in the sparse layout.
+bool preferSparse(std::size_t vertexCount, std::size_t arcCount);
+
+} // namespace core
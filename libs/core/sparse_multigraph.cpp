@@ -0,0 +1,149 @@
+#include "sparse_multigraph.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace core
+{
+
+SparseMultigraph::SparseMultigraph() : _rowOffsets(1, 0) {
+}
+
+SparseMultigraph::SparseMultigraph(const core::Multigraph& multigraph, unsigned int k)
+    : _rowOffsets(multigraph.vertexCount() + 1, 0) {
+    for (vertex u = 0; u < multigraph.vertexCount(); u++) {
+        for (vertex v : multigraph.neighbours(u)) {
+            if (multigraph.edgeCount(u, v) < k) continue;
+            _columns.push_back(v);
+            _multiplicities.push_back(static_cast<multiplicity>(multigraph.edgeCount(u, v)));
+        }
+        _rowOffsets[u + 1] = _columns.size();
+    }
+}
+
+std::size_t SparseMultigraph::vertexCount() const {
+    return _rowOffsets.size() - 1;
+}
+
+std::size_t SparseMultigraph::arcCount() const {
+    return _columns.size();
+}
+
+std::size_t SparseMultigraph::find(vertex u, vertex v) const {
+    auto first = _columns.begin() + _rowOffsets[u];
+    auto last = _columns.begin() + _rowOffsets[u + 1];
+    auto it = std::lower_bound(first, last, v);
+    if (it == last || *it != v) return std::numeric_limits<std::size_t>::max();
+    return it - _columns.begin();
+}
+
+std::size_t SparseMultigraph::edgeCount(std::size_t from, std::size_t to) const {
+    auto position = find(from, to);
+    return position == std::numeric_limits<std::size_t>::max() ? 0 : _multiplicities[position];
+}
+
+std::size_t SparseMultigraph::outDegree(std::size_t vertex) const {
+    auto row = multiplicities(vertex);
+    return std::accumulate(row.begin(), row.end(), (std::size_t)0);
+}
+
+Size SparseMultigraph::size() const {
+    std::size_t edgeCount = 0;
+    std::size_t maxDegree = 0;
+    for (const auto edges : _multiplicities) {
+        edgeCount += edges;
+        maxDegree = maxDegree > edges ? maxDegree : edges;
+    }
+    return Size{vertexCount(), edgeCount, maxDegree};
+}
+
+bool SparseMultigraph::hasEdge(vertex u, vertex v) const {
+    return find(u, v) != std::numeric_limits<std::size_t>::max();
+}
+
+void SparseMultigraph::removeAllEdges(vertex v) {
+    std::size_t kept = 0;
+    std::size_t rowBegin = 0;
+    for (vertex u = 0; u < vertexCount(); u++) {
+        std::size_t rowEnd = _rowOffsets[u + 1];
+        if (u != v) {
+            for (std::size_t i = rowBegin; i < rowEnd; i++) {
+                if (_columns[i] == v) continue;
+                _columns[kept] = _columns[i];
+                _multiplicities[kept] = _multiplicities[i];
+                kept++;
+            }
+        }
+        rowBegin = rowEnd;
+        _rowOffsets[u + 1] = kept;
+    }
+    _columns.resize(kept);
+    _multiplicities.resize(kept);
+}
+
+std::span<const vertex> SparseMultigraph::neighbours(vertex v) const {
+    return std::span<const vertex>(_columns.data() + _rowOffsets[v], _rowOffsets[v + 1] - _rowOffsets[v]);
+}
+
+std::span<const multiplicity> SparseMultigraph::multiplicities(vertex v) const {
+    return std::span<const multiplicity>(_multiplicities.data() + _rowOffsets[v],
+                                         _rowOffsets[v + 1] - _rowOffsets[v]);
+}
+
+SparseMultigraph SparseMultigraph::inducedSubgraph(const std::vector<vertex>& vertices) const {
+    const std::size_t NOT_INDUCED = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> newIndex(vertexCount(), NOT_INDUCED);
+    for (vertex v = 0; v < vertices.size(); v++) {
+        newIndex[vertices[v]] = v;
+    }
+
+    SparseMultigraph G;
+    G._rowOffsets.assign(vertices.size() + 1, 0);
+    std::vector<std::pair<vertex, multiplicity>> row;
+    for (vertex v = 0; v < vertices.size(); v++) {
+        row.clear();
+        auto columns = neighbours(vertices[v]);
+        auto edges = multiplicities(vertices[v]);
+        for (std::size_t i = 0; i < columns.size(); i++) {
+            if (newIndex[columns[i]] != NOT_INDUCED) row.emplace_back(newIndex[columns[i]], edges[i]);
+        }
+        std::sort(row.begin(), row.end());
+        for (const auto& [u, count] : row) {
+            G._columns.push_back(u);
+            G._multiplicities.push_back(count);
+        }
+        G._rowOffsets[v + 1] = G._columns.size();
+    }
+    return G;
+}
+
+SparseMultigraph SparseMultigraph::kGraph(unsigned int k) const {
+    SparseMultigraph G;
+    G._rowOffsets.assign(_rowOffsets.size(), 0);
+    for (vertex u = 0; u < vertexCount(); u++) {
+        for (std::size_t i = _rowOffsets[u]; i < _rowOffsets[u + 1]; i++) {
+            if (_multiplicities[i] < k) continue;
+            G._columns.push_back(_columns[i]);
+            G._multiplicities.push_back(_multiplicities[i]);
+        }
+        G._rowOffsets[u + 1] = G._columns.size();
+    }
+    return G;
+}
+
+Multigraph SparseMultigraph::toMultigraph() const {
+    std::vector<std::vector<std::size_t>> adjacencyMatrix(vertexCount(), std::vector<std::size_t>(vertexCount(), 0));
+    for (vertex u = 0; u < vertexCount(); u++) {
+        for (std::size_t i = _rowOffsets[u]; i < _rowOffsets[u + 1]; i++) {
+            adjacencyMatrix[u][_columns[i]] = _multiplicities[i];
+        }
+    }
+    return Multigraph(adjacencyMatrix);
+}
+
+bool preferSparse(std::size_t vertexCount, std::size_t arcCount) {
+    return static_cast<double>(arcCount) < SPARSE_DENSITY_THRESHOLD * vertexCount * vertexCount;
+}
+
+} // namespace core
@@ -0,0 +1,123 @@
+#pragma once
+#include "core.hpp"
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace cycleFinder
+{
+// Set of vertices hidden from a graph. Every hide is recorded in an undo log, so that a checkpoint taken before a
+// batch of changes can be restored in O(changes) instead of copying the graph.
+class VertexMask {
+  private:
+    std::vector<bool> hidden_;
+    std::vector<vertex> undoLog_;
+
+  public:
+    VertexMask(std::size_t vertexCount = 0);
+
+    std::size_t vertexCount() const;
+    bool contains(vertex v) const {
+        return !hidden_[v];
+    }
+
+    void hide(vertex v);
+    // hides every vertex outside the given set, the remaining graph is the subgraph induced by it
+    void restrictTo(const std::vector<vertex>& vertices);
+
+    std::size_t checkpoint() const;
+    void rollback(std::size_t checkpoint);
+};
+
+// Allocation-free range over the neighbours of one vertex that are not hidden by a mask.
+template <typename Range> class MaskedNeighbourRange {
+  public:
+    using base_iterator = decltype(std::declval<const Range&>().begin());
+
+    class iterator {
+      private:
+        base_iterator current_;
+        base_iterator end_;
+        const VertexMask* mask_ = nullptr;
+
+        void skipHidden() {
+            while (current_ != end_ && !mask_->contains(*current_))
+                ++current_;
+        }
+
+      public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = vertex;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const vertex*;
+        using reference = vertex;
+
+        iterator() = default;
+        iterator(base_iterator current, base_iterator end, const VertexMask* mask)
+            : current_(current), end_(end), mask_(mask) {
+            skipHidden();
+        }
+
+        vertex operator*() const {
+            return *current_;
+        }
+        iterator& operator++() {
+            ++current_;
+            skipHidden();
+            return *this;
+        }
+        iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+        bool operator==(const iterator& other) const {
+            return current_ == other.current_;
+        }
+    };
+
+    // a range built with hiddenSource set is empty, a hidden vertex has no out-neighbours
+    MaskedNeighbourRange(Range range, const VertexMask& mask, bool hiddenSource = false)
+        : range_(range), mask_(&mask), hiddenSource_(hiddenSource) {
+    }
+
+    iterator begin() const {
+        if (hiddenSource_) return end();
+        return iterator(range_.begin(), range_.end(), mask_);
+    }
+    iterator end() const {
+        return iterator(range_.end(), range_.end(), mask_);
+    }
+
+  private:
+    Range range_;
+    const VertexMask* mask_;
+    bool hiddenSource_;
+};
+
+// Non-owning view of a graph with the vertices hidden by a mask removed. Hidden vertices keep their labels and
+// have neither in- nor out-neighbours, so solvers see the same graph as after removeAllEdges on each of them.
+template <typename Graph> class MaskedGraph {
+  private:
+    const Graph& graph_;
+    const VertexMask& mask_;
+
+  public:
+    using range = decltype(std::declval<const Graph&>().neighbours(vertex{}));
+
+    MaskedGraph(const Graph& graph, const VertexMask& mask) : graph_(graph), mask_(mask) {
+    }
+
+    std::size_t vertexCount() const {
+        return graph_.vertexCount();
+    }
+    bool contains(vertex v) const {
+        return mask_.contains(v);
+    }
+    MaskedNeighbourRange<range> neighbours(vertex v) const {
+        return MaskedNeighbourRange<range>(graph_.neighbours(v), mask_, !mask_.contains(v));
+    }
+};
+} // namespace cycleFinder
@@ -1,7 +1,8 @@
 #pragma once
 #include "core.hpp"
+#include "masked_graph.hpp"
+#include "solver_graph.hpp"
 #include "strongly_connected_components.hpp"
-#include <unordered_map>
 #include <vector>
 namespace cycleFinder
 {
@@ -11,28 +12,38 @@ class MaxCycle {
     std::vector<std::vector<vertex>> maxCycles_;
     std::vector<std::vector<vertex>> maxCyclesExact_;
     std::vector<vertex> stack_;
-    std::set<vertex> blocked_;
-    std::unordered_map<vertex, std::vector<vertex>> blockedMap_;
+    std::vector<bool> blocked_;
+    std::vector<std::vector<vertex>> blockedMap_;
 
     core::Size maxCycleSizeExact_ = core::Size{0, 0, 0};
-    const core::Multigraph baseMultiGraph_;
-    core::Multigraph multiGraph_;
+    const core::Multigraph& baseMultiGraph_;
+    SolverGraph multiGraph_;
+    // vertices eliminated by solve() and outside the component being searched, rolled back when solve() returns
+    VertexMask mask_;
     StronglyConnectedComponents stronglyConnectedComponentsFinder_;
     vertex leastVertex_;
     unsigned int k_;
     std::size_t maxCycleSize_ = 0;
-    void processStronglyConnectedComponent(const std::vector<vertex>& stronglyConnectedComponent);
+    template <typename Graph> void eliminateVertices(const Graph& multiGraph);
+    template <typename Graph>
+    void processStronglyConnectedComponent(const MaskedGraph<Graph>& multiGraph, std::vector<vertex> scc);
 
     void unblockVertex(vertex v);
-    bool processVertex(vertex v, const core::Multigraph& multiGraph, const std::vector<vertex>& scc);
+    template <typename Graph> bool processVertex(vertex v, const Graph& multiGraph);
     void filterMaxCycles();
     void filterMaxCyclesExact();
 
   public:
     std::vector<std::vector<vertex>> getMaxVertexCycles();
+    // multiGraph is read by reference and has to outlive the solver
     MaxCycle(const core::Multigraph& multiGraph, unsigned int k);
     std::vector<std::vector<vertex>> solve();
     std::vector<std::vector<vertex>> approximate();
     core::Size getMaxSize();
+    // vertices of the strongly connected components with at least two vertices, the only ones on cycles
+    std::vector<vertex> cyclicVertices();
+    // hides the vertices outside the given ones from solve and approximate, for vertices known to lie on no cycle,
+    // such as those on no cycle of the graph for a smaller k
+    void restrictTo(const std::vector<vertex>& vertices);
 };
 } // namespace cycleFinder
\ No newline at end of file
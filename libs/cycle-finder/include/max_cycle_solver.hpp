@@ -2,9 +2,21 @@
 #include <vector>
 namespace cycleFinder
 {
+// max cycles of the k-graph for one k of a sweep
+struct MaxCycleSweepResult {
+    unsigned int k;
+    std::vector<std::vector<vertex>> cycles;
+    core::Size size;
+};
+
 class MaxCycleSolver {
   public:
     std::vector<std::vector<vertex>> solve(const core::Multigraph& G, const unsigned int k);
     std::vector<std::vector<vertex>> approximate(const core::Multigraph& G, const unsigned int k);
+    // Max cycles for every k from kFirst to kLast. The k-graphs are nested, a vertex on no cycle for k is on none for
+    // k + 1, so consecutive runs of k are handed to the `threads` workers (0 meaning one per hardware thread) and each
+    // run of the exact search explores only the strongly connected components left by the previous k.
+    std::vector<MaxCycleSweepResult> sweep(const core::Multigraph& G, unsigned int kFirst, unsigned int kLast,
+                                           bool approx, unsigned int threads = 1);
 };
 } // namespace cycleFinder
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+#include "core.hpp"
+#include "bit_graph.hpp"
+#include "sparse_multigraph.hpp"
+#include <variant>
+
+namespace cycleFinder
+{
+// Graph layouts the cycle-finder solvers can traverse. Every alternative exposes vertexCount(), neighbours(v),
+// inducedSubgraph(vertices) and removeAllEdges(v).
+using SolverGraph = std::variant<core::KThresholdBitGraph, core::SparseMultigraph>;
+
+// Builds the k-graph of the given multigraph in the layout with the cheaper neighbour iteration for its density.
+SolverGraph makeSolverGraph(const core::Multigraph& multiGraph, unsigned int k = 1);
+} // namespace cycleFinder
@@ -1,25 +1,31 @@
 #pragma once
 #include "core.hpp"
+#include "masked_graph.hpp"
+#include "solver_graph.hpp"
 #include <stack>
 #include <vector>
-#include <set>
 namespace cycleFinder
 {
 class StronglyConnectedComponents {
   private:
     std::vector<vertex> low_;
-    std::set<vertex> onStack_;
+    std::vector<bool> onStack_;
     std::stack<vertex> stack_;
     std::vector<bool> visited_;
     std::vector<unsigned int> visitedTime_;
     std::vector<std::vector<vertex>> stronglyConnectedComponents_;
-    core::Multigraph multiGraph_;
+    SolverGraph multiGraph_;
     unsigned int time_ = 0;
 
-    void processVertex(vertex v);
+    void reset(std::size_t vertexCount);
+    template <typename Graph> void processVertex(const Graph& multiGraph, vertex v);
 
   public:
+    StronglyConnectedComponents();
     StronglyConnectedComponents(const core::Multigraph& multiGraph_);
+    StronglyConnectedComponents(SolverGraph multiGraph_);
     std::vector<std::vector<vertex>> solve();
+    // components of an external graph, the finder's buffers are reused between calls
+    template <typename Graph> std::vector<std::vector<vertex>> solve(const Graph& multiGraph);
 };
 } // namespace cycleFinder
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "masked_graph.hpp"
+#include <vector>
+
+namespace cycleFinder
+{
+VertexMask::VertexMask(std::size_t vertexCount) : hidden_(vertexCount) {
+}
+
+std::size_t VertexMask::vertexCount() const {
+    return hidden_.size();
+}
+
+void VertexMask::hide(vertex v) {
+    if (hidden_[v]) return;
+    hidden_[v] = true;
+    undoLog_.push_back(v);
+}
+
+void VertexMask::restrictTo(const std::vector<vertex>& vertices) {
+    auto keep = std::vector<bool>(hidden_.size());
+    for (auto v : vertices)
+        keep[v] = true;
+    for (vertex v = 0; v < hidden_.size(); v++) {
+        if (!keep[v]) hide(v);
+    }
+}
+
+std::size_t VertexMask::checkpoint() const {
+    return undoLog_.size();
+}
+
+void VertexMask::rollback(std::size_t checkpoint) {
+    while (undoLog_.size() > checkpoint) {
+        hidden_[undoLog_.back()] = false;
+        undoLog_.pop_back();
+    }
+}
+} // namespace cycleFinder
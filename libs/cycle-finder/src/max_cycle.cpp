@@ -2,18 +2,24 @@
 #include "max_cycle.hpp"
 #include "strongly_connected_components.hpp"
 #include <algorithm>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace cycleFinder
 {
 MaxCycle::MaxCycle(const core::Multigraph& multiGraph, unsigned int k)
-    : multiGraph_(multiGraph.kGraph(k)), k_(k), stronglyConnectedComponentsFinder_(multiGraph_),
-      baseMultiGraph_(multiGraph) {
+    : baseMultiGraph_(multiGraph), multiGraph_(makeSolverGraph(multiGraph, k)), mask_(multiGraph.vertexCount()),
+      k_(k) {
 }
 
 std::vector<std::vector<vertex>> MaxCycle::approximate() {
     cycles_ = std::vector<std::vector<vertex>>();
-    auto stronglyConnectedComponents = stronglyConnectedComponentsFinder_.solve();
+    auto stronglyConnectedComponents = std::visit(
+        [this](const auto& multiGraph) {
+            return stronglyConnectedComponentsFinder_.solve(MaskedGraph(multiGraph, mask_));
+        },
+        multiGraph_);
 
     std::size_t maxSize = 0;
     for (const auto& stronglyConnectedComponent : stronglyConnectedComponents)
@@ -30,65 +36,68 @@ std::vector<std::vector<vertex>> MaxCycle::approximate() {
 }
 
 std::vector<std::vector<vertex>> MaxCycle::solve() {
-
-    auto stronglyConnectedComponents = stronglyConnectedComponentsFinder_.solve();
-    auto filteredSCC = std::vector<std::vector<vertex>>();
-    for (const auto& scc : stronglyConnectedComponents) {
-        if (scc.size() > 1) filteredSCC.push_back(scc);
-    }
-    std::sort(stronglyConnectedComponents.begin(), stronglyConnectedComponents.end(),
-              [](const std::vector<vertex>& a, const std::vector<vertex>& b) { return a.size() > b.size(); });
-
-    while (filteredSCC.empty() == false) {
-        auto firstSCC = filteredSCC.front();
-        if (firstSCC.size() <= maxCycleSize_) break;
-        std::sort(firstSCC.begin(), firstSCC.end());
-        processStronglyConnectedComponent(firstSCC);
-        leastVertex_ = firstSCC[0];
-        multiGraph_.removeAllEdges(leastVertex_);
-        stronglyConnectedComponentsFinder_ = StronglyConnectedComponents(multiGraph_);
-        stronglyConnectedComponents = stronglyConnectedComponentsFinder_.solve();
-        filteredSCC.clear();
-        for (const auto& scc : stronglyConnectedComponents) {
-            if (scc.size() > 1) filteredSCC.push_back(scc);
-        }
-    }
+    const auto start = mask_.checkpoint();
+    std::visit([this](const auto& multiGraph) { eliminateVertices(multiGraph); }, multiGraph_);
+    mask_.rollback(start);
 
     filterMaxCyclesExact();
     return maxCyclesExact_;
 }
 
-void MaxCycle::processStronglyConnectedComponent(const std::vector<vertex>& scc) {
-    blocked_.clear();
-    blockedMap_.clear();
+template <typename Graph> void MaxCycle::eliminateVertices(const Graph& multiGraph) {
+    const auto remaining = MaskedGraph<Graph>(multiGraph, mask_);
+
+    while (true) {
+        auto stronglyConnectedComponents = stronglyConnectedComponentsFinder_.solve(remaining);
+        auto largest = std::max_element(
+            stronglyConnectedComponents.begin(), stronglyConnectedComponents.end(),
+            [](const std::vector<vertex>& a, const std::vector<vertex>& b) { return a.size() < b.size(); });
+
+        // a closed cycle repeats its first vertex, so a component of n vertices holds cycles of size at most n + 1
+        if (largest == stronglyConnectedComponents.end() || largest->size() < 2 ||
+            largest->size() + 1 < maxCycleSize_)
+            break;
+
+        std::sort(largest->begin(), largest->end());
+        leastVertex_ = largest->front();
+        processStronglyConnectedComponent(remaining, std::move(*largest));
+        mask_.hide(leastVertex_);
+    }
+}
+
+template <typename Graph>
+void MaxCycle::processStronglyConnectedComponent(const MaskedGraph<Graph>& multiGraph, std::vector<vertex> scc) {
+    const auto start = mask_.checkpoint();
+    mask_.restrictTo(scc);
+
+    blocked_.assign(multiGraph.vertexCount(), false);
+    blockedMap_.resize(multiGraph.vertexCount());
+    for (auto v : scc)
+        blockedMap_[v].clear();
     stack_.clear();
 
-    auto G = multiGraph_.inducedSubgraph(scc);
-    leastVertex_ = 0;
-    processVertex(leastVertex_, G, scc);
+    processVertex(leastVertex_, multiGraph);
+    mask_.rollback(start);
 }
 
-bool MaxCycle::processVertex(vertex v, const core::Multigraph& multiGraph, const std::vector<vertex>& scc) {
+template <typename Graph> bool MaxCycle::processVertex(vertex v, const Graph& multiGraph) {
     bool foundCycle = false;
     stack_.push_back(v);
-    blocked_.insert(v);
+    blocked_[v] = true;
 
-    for (auto neighbour : multiGraph.getNeighbours(v)) {
-        if (neighbour == 0) {
+    for (auto neighbour : multiGraph.neighbours(v)) {
+        if (neighbour == leastVertex_) {
             foundCycle = true;
 
-            std::vector<vertex> cycle = std::vector<vertex>(stack_.size() + 1);
-            for (auto v = 0; v < stack_.size(); v++) {
-                cycle[v] = scc[stack_[v]];
-            }
-            cycle[cycle.size() - 1] = scc[0];
+            std::vector<vertex> cycle = stack_;
+            cycle.push_back(leastVertex_);
             if (cycle.size() >= maxCycleSize_) {
                 maxCycleSize_ = cycle.size();
                 cycles_.push_back(cycle);
             }
 
-        } else if (!blocked_.contains(neighbour))
-            foundCycle |= processVertex(neighbour, multiGraph, scc);
+        } else if (!blocked_[neighbour])
+            foundCycle |= processVertex(neighbour, multiGraph);
     }
 
     if (foundCycle) {
@@ -96,12 +105,9 @@ bool MaxCycle::processVertex(vertex v, const core::Multigraph& multiGraph, const
     }
 
     else {
-        for (auto neighbour : multiGraph.getNeighbours(v)) {
-            // add them to blocked map;
-            auto currentNeighbourBlockings =
-                blockedMap_.contains(neighbour) ? blockedMap_[neighbour] : std::vector<vertex>();
-            currentNeighbourBlockings.push_back(v);
-            blockedMap_.insert({neighbour, currentNeighbourBlockings});
+        for (auto neighbour : multiGraph.neighbours(v)) {
+            auto& blockings = blockedMap_[neighbour];
+            if (std::find(blockings.begin(), blockings.end(), v) == blockings.end()) blockings.push_back(v);
         }
     }
     stack_.pop_back();
@@ -109,13 +115,14 @@ bool MaxCycle::processVertex(vertex v, const core::Multigraph& multiGraph, const
 }
 
 void MaxCycle::unblockVertex(vertex v) {
-    blocked_.erase(v);
-    for (auto u : blockedMap_[v]) {
-        if (blocked_.contains(u)) {
+    blocked_[v] = false;
+    auto blockings = std::move(blockedMap_[v]);
+    blockedMap_[v].clear();
+    for (auto u : blockings) {
+        if (blocked_[u]) {
             unblockVertex(u);
         }
     }
-    blockedMap_.erase(v);
 }
 
 void MaxCycle::filterMaxCycles() {
@@ -128,17 +135,17 @@ void MaxCycle::filterMaxCyclesExact() {
     if (cycles_.empty()) return;
 
     this->filterMaxCycles();
-    auto graphCycles = std::vector<core::Multigraph>(maxCycles_.size());
-    for (int i = 0; i < graphCycles.size(); i++) {
-        graphCycles[i] = baseMultiGraph_.cycleGraph(maxCycles_[i]);
+    auto cycleSizes = std::vector<core::Size>(maxCycles_.size());
+    for (int i = 0; i < cycleSizes.size(); i++) {
+        cycleSizes[i] = baseMultiGraph_.cycleSize(maxCycles_[i]);
     }
 
-    for (const auto& cycle : graphCycles) {
-        if (cycle.size() > maxCycleSizeExact_) maxCycleSizeExact_ = cycle.size();
+    for (const auto& cycleSize : cycleSizes) {
+        if (cycleSize > maxCycleSizeExact_) maxCycleSizeExact_ = cycleSize;
     }
 
-    for (int i = 0; i < graphCycles.size(); i++) {
-        if (graphCycles[i].size() == maxCycleSizeExact_) {
+    for (int i = 0; i < cycleSizes.size(); i++) {
+        if (cycleSizes[i] == maxCycleSizeExact_) {
             maxCyclesExact_.push_back(maxCycles_[i]);
         }
     }
@@ -152,4 +159,24 @@ core::Size MaxCycle::getMaxSize() {
     return maxCycleSizeExact_;
 }
 
+std::vector<vertex> MaxCycle::cyclicVertices() {
+    auto stronglyConnectedComponents = std::visit(
+        [this](const auto& multiGraph) {
+            return stronglyConnectedComponentsFinder_.solve(MaskedGraph(multiGraph, mask_));
+        },
+        multiGraph_);
+
+    std::vector<vertex> vertices;
+    for (const auto& stronglyConnectedComponent : stronglyConnectedComponents) {
+        if (stronglyConnectedComponent.size() < 2) continue;
+        vertices.insert(vertices.end(), stronglyConnectedComponent.begin(), stronglyConnectedComponent.end());
+    }
+    std::sort(vertices.begin(), vertices.end());
+    return vertices;
+}
+
+void MaxCycle::restrictTo(const std::vector<vertex>& vertices) {
+    mask_.restrictTo(vertices);
+}
+
 } // namespace cycleFinder
\ No newline at end of file
@@ -1,7 +1,11 @@
 #include "max_cycle_solver.hpp"
 #include "core.hpp"
 #include "max_cycle.hpp"
+#include "parallel.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 std::vector<std::vector<vertex>> cycleFinder::MaxCycleSolver::solve(const core::Multigraph& multiGraph,
@@ -14,4 +18,32 @@ std::vector<std::vector<vertex>> cycleFinder::MaxCycleSolver::approximate(const
                                                                           const unsigned int k) {
     auto solver = cycleFinder::MaxCycle(multiGraph, k);
     return solver.approximate();
-}
\ No newline at end of file
+}
+
+std::vector<cycleFinder::MaxCycleSweepResult> cycleFinder::MaxCycleSolver::sweep(const core::Multigraph& multiGraph,
+                                                                                 unsigned int kFirst,
+                                                                                 unsigned int kLast, bool approx,
+                                                                                 unsigned int threads) {
+    if (kFirst > kLast) throw std::invalid_argument("Empty range of k");
+    const std::size_t count = kLast - kFirst + 1;
+    const std::size_t workers = std::min<std::size_t>(core::resolveThreadCount(threads), count);
+
+    std::vector<MaxCycleSweepResult> results(count);
+    core::parallelFor(workers, static_cast<unsigned int>(workers), [&](std::size_t worker) {
+        // worker w takes the w-th of `workers` consecutive runs of k. The exact search skips the vertices the previous
+        // k left outside every cycle; the approximation reads cycles off the component search order, which hiding
+        // vertices would change, so it always sees the whole graph
+        std::vector<vertex> cyclic;
+        for (std::size_t i = worker * count / workers; i < (worker + 1) * count / workers; i++) {
+            const unsigned int k = kFirst + static_cast<unsigned int>(i);
+            auto solver = cycleFinder::MaxCycle(multiGraph, k);
+            if (!approx) {
+                if (i != worker * count / workers) solver.restrictTo(cyclic);
+                cyclic = solver.cyclicVertices();
+            }
+            auto cycles = approx ? solver.approximate() : solver.solve();
+            results[i] = MaxCycleSweepResult{k, std::move(cycles), solver.getMaxSize()};
+        }
+    });
+    return results;
+}
@@ -0,0 +1,12 @@
+#include "solver_graph.hpp"
+
+namespace cycleFinder
+{
+SolverGraph makeSolverGraph(const core::Multigraph& multiGraph, unsigned int k) {
+    auto kGraph = core::KThresholdBitGraph(multiGraph, k);
+    if (core::preferSparse(kGraph.vertexCount(), kGraph.arcCount())) {
+        return core::SparseMultigraph(multiGraph, k);
+    }
+    return kGraph;
+}
+} // namespace cycleFinder
@@ -1,36 +1,58 @@
 #include "core.hpp"
 #include "strongly_connected_components.hpp"
 #include <algorithm>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace cycleFinder
 {
+StronglyConnectedComponents::StronglyConnectedComponents() : multiGraph_(core::KThresholdBitGraph()) {
+}
+
 StronglyConnectedComponents::StronglyConnectedComponents(const core::Multigraph& multiGraph)
-    : multiGraph_(multiGraph), low_(std::vector<vertex>(multiGraph.vertexCount())),
-      visited_(std::vector<bool>(multiGraph.vertexCount())),
-      visitedTime_(std::vector<unsigned int>(multiGraph.vertexCount())) {
+    : StronglyConnectedComponents(makeSolverGraph(multiGraph)) {
+}
+
+StronglyConnectedComponents::StronglyConnectedComponents(SolverGraph multiGraph) : multiGraph_(std::move(multiGraph)) {
+}
+
+void StronglyConnectedComponents::reset(std::size_t vertexCount) {
+    low_.assign(vertexCount, 0);
+    onStack_.assign(vertexCount, false);
+    visited_.assign(vertexCount, false);
+    visitedTime_.assign(vertexCount, 0);
+    stack_ = std::stack<vertex>();
+    stronglyConnectedComponents_.clear();
+    time_ = 0;
 }
 
 std::vector<std::vector<vertex>> StronglyConnectedComponents::solve() {
-    for (vertex v = 0; v < multiGraph_.vertexCount(); v++) {
-        if (!visited_[v]) processVertex(v);
+    return std::visit([this](const auto& multiGraph) { return solve(multiGraph); }, multiGraph_);
+}
+
+template <typename Graph>
+std::vector<std::vector<vertex>> StronglyConnectedComponents::solve(const Graph& multiGraph) {
+    reset(multiGraph.vertexCount());
+    for (vertex v = 0; v < multiGraph.vertexCount(); v++) {
+        if (!visited_[v]) processVertex(multiGraph, v);
     }
     return stronglyConnectedComponents_;
 }
 
-void StronglyConnectedComponents::processVertex(vertex v) {
+template <typename Graph> void StronglyConnectedComponents::processVertex(const Graph& multiGraph, vertex v) {
     visited_[v] = true;
     visitedTime_[v] = time_;
 
     low_[v] = time_++;
     stack_.push(v);
-    onStack_.insert(v);
+    onStack_[v] = true;
 
-    for (vertex child : multiGraph_.getNeighbours(v)) {
+    for (vertex child : multiGraph.neighbours(v)) {
         if (visited_[child] == false) {
-            processVertex(child);
+            processVertex(multiGraph, child);
             low_[v] = std::min(low_[v], low_[child]);
-        } else if (onStack_.contains(child)) {
+        } else if (onStack_[child]) {
             low_[v] = std::min(low_[v], low_[child]);
         }
     }
@@ -38,15 +60,24 @@ void StronglyConnectedComponents::processVertex(vertex v) {
     if (visitedTime_[v] != low_[v]) return;
     auto scc = std::vector<vertex>();
 
-    while (stack_.size() > 0 && low_[stack_.top()] == low_[v]) {
-        auto u = stack_.top();
+    // v is the root of its component, everything above it on the stack belongs to the same component
+    vertex u;
+    do {
+        u = stack_.top();
 
         stack_.pop();
-        onStack_.erase(u);
+        onStack_[u] = false;
         scc.push_back(u);
-    };
+    } while (u != v);
 
     stronglyConnectedComponents_.push_back(scc);
 }
 
+template std::vector<std::vector<vertex>> StronglyConnectedComponents::solve(const core::KThresholdBitGraph&);
+template std::vector<std::vector<vertex>> StronglyConnectedComponents::solve(const core::SparseMultigraph&);
+template std::vector<std::vector<vertex>> StronglyConnectedComponents::solve(
+    const MaskedGraph<core::KThresholdBitGraph>&);
+template std::vector<std::vector<vertex>> StronglyConnectedComponents::solve(
+    const MaskedGraph<core::SparseMultigraph>&);
+
 } // namespace cycleFinder
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "generator.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace generator
+{
+// row streams are split by vertex index, graph-wide structure uses a stream no row can reach
+static const std::uint64_t STRUCTURE_STREAM = std::numeric_limits<std::uint64_t>::max();
+
+Family parseFamily(const std::string& name) {
+    if (name == "erdos-renyi") return Family::ErdosRenyi;
+    if (name == "power-law") return Family::PowerLaw;
+    if (name == "hamiltonian") return Family::PlantedHamiltonian;
+    if (name == "clustered") return Family::Clustered;
+    throw std::invalid_argument("Unknown graph family: " + name);
+}
+
+Generator::Generator(const GeneratorParameters& parameters, std::uint64_t seed, unsigned int threads)
+    : _parameters(parameters), _root(seed), _threads(core::resolveThreadCount(threads)) {
+    if (_parameters.vertexCount == 0) {
+        throw std::invalid_argument("Generated multigraphs need at least one vertex");
+    }
+    if (_parameters.maxMultiplicity == 0) {
+        throw std::invalid_argument("Maximal multiplicity must be positive");
+    }
+    if (_parameters.maxMultiplicity > std::numeric_limits<core::multiplicity>::max() ||
+        _parameters.k > std::numeric_limits<core::multiplicity>::max()) {
+        throw std::out_of_range("Requested multiplicity does not fit in " + std::to_string(TAIO_MULTIPLICITY_BITS) +
+                                " bits");
+    }
+    if (_parameters.family == Family::Clustered && _parameters.clusterCount == 0) {
+        throw std::invalid_argument("Cluster count must be positive");
+    }
+}
+
+void Generator::generateRow(vertex u, RandomStream& stream, const std::vector<vertex>& successor,
+                            const std::vector<std::uint64_t>& degreeDistribution, core::multiplicity* row) const {
+    const std::size_t n = _parameters.vertexCount;
+    auto drawMultiplicity = [&]() {
+        return static_cast<core::multiplicity>(1 + stream.uniform(_parameters.maxMultiplicity));
+    };
+
+    switch (_parameters.family) {
+    case Family::ErdosRenyi:
+    case Family::PlantedHamiltonian:
+        for (vertex v = 0; v < n; v++) {
+            if (v != u && stream.bernoulli(_parameters.density)) row[v] = drawMultiplicity();
+        }
+        if (_parameters.family == Family::PlantedHamiltonian && n > 1) {
+            auto& cycleEdge = row[successor[u]];
+            cycleEdge = std::max(cycleEdge, static_cast<core::multiplicity>(_parameters.k));
+        }
+        break;
+    case Family::Clustered: {
+        auto cluster = [&](vertex v) { return v * _parameters.clusterCount / n; };
+        for (vertex v = 0; v < n; v++) {
+            if (v == u) continue;
+            double density = cluster(u) == cluster(v) ? _parameters.density : _parameters.bridgeDensity;
+            if (stream.bernoulli(density)) row[v] = drawMultiplicity();
+        }
+        break;
+    }
+    case Family::PowerLaw: {
+        if (n < 2) break;
+        std::uint64_t draw = stream.next();
+        std::size_t degree =
+            std::upper_bound(degreeDistribution.begin(), degreeDistribution.end(), draw) - degreeDistribution.begin();
+        degree = std::min(degree + 1, n - 1);
+
+        // Floyd's sampling of `degree` distinct targets among the n - 1 other vertices
+        for (std::size_t j = n - 1 - degree; j < n - 1; j++) {
+            std::size_t target = stream.uniform(j + 1);
+            vertex v = target < u ? target : target + 1;
+            if (row[v] != 0) v = j < u ? j : j + 1;
+            row[v] = drawMultiplicity();
+        }
+        break;
+    }
+    }
+}
+
+core::Multigraph Generator::generate(std::size_t index) const {
+    return generate(index, 1).front();
+}
+
+std::vector<core::Multigraph> Generator::generate(std::size_t first, std::size_t count) const {
+    const std::size_t n = _parameters.vertexCount;
+
+    // cumulative out-degree distribution in 64-bit fixed point, entry d - 1 covers out-degree d
+    std::vector<std::uint64_t> degreeDistribution;
+    if (_parameters.family == Family::PowerLaw && n > 1) {
+        std::vector<double> weights(n - 1);
+        double total = 0;
+        for (std::size_t d = 1; d < n; d++) {
+            total += weights[d - 1] = std::pow(static_cast<double>(d), -_parameters.exponent);
+        }
+        double cumulative = 0;
+        for (std::size_t d = 1; d < n; d++) {
+            cumulative += weights[d - 1];
+            double fraction = cumulative / total;
+            degreeDistribution.push_back(fraction >= 1.0 ? std::numeric_limits<std::uint64_t>::max()
+                                                         : static_cast<std::uint64_t>(fraction * 0x1.0p64));
+        }
+        degreeDistribution.back() = std::numeric_limits<std::uint64_t>::max();
+    }
+
+    std::vector<core::Multigraph> multigraphs(count);
+    // spread whole graphs over the workers when there are enough of them, otherwise spread the rows of each graph
+    unsigned int graphThreads = count >= _threads ? _threads : 1;
+    unsigned int rowThreads = count >= _threads ? 1 : _threads;
+
+    core::parallelFor(count, graphThreads, [&](std::size_t i) {
+        auto stream = _root.split(first + i);
+
+        std::vector<vertex> successor;
+        if (_parameters.family == Family::PlantedHamiltonian) {
+            auto structure = stream.split(STRUCTURE_STREAM);
+            std::vector<vertex> order(n);
+            for (vertex v = 0; v < n; v++)
+                order[v] = v;
+            for (std::size_t j = n - 1; j > 0; j--)
+                std::swap(order[j], order[structure.uniform(j + 1)]);
+            successor.resize(n);
+            for (std::size_t j = 0; j < n; j++)
+                successor[order[j]] = order[(j + 1) % n];
+        }
+
+        std::vector<core::multiplicity> adjacencyMatrix(n * n, 0);
+        core::parallelFor(
+            n, rowThreads,
+            [&](std::size_t u) {
+                auto rowStream = stream.split(u);
+                generateRow(u, rowStream, successor, degreeDistribution, adjacencyMatrix.data() + u * n);
+            },
+            16);
+        multigraphs[i] = core::Multigraph(n, std::move(adjacencyMatrix));
+    });
+
+    return multigraphs;
+}
+
+void writeMultigraph(std::ostream& output, const core::Multigraph& multigraph) {
+    const std::size_t n = multigraph.vertexCount();
+    std::string buffer;
+    buffer.reserve(n * n * 2 + 32);
+    char number[32];
+
+    auto append = [&](std::size_t value, char separator) {
+        auto end = std::to_chars(number, number + sizeof(number), value).ptr;
+        buffer.append(number, end);
+        buffer.push_back(separator);
+    };
+
+    append(n, '\n');
+    for (vertex u = 0; u < n; u++) {
+        auto row = multigraph.row(u);
+        for (vertex v = 0; v < n; v++) {
+            append(row[v], v + 1 < n ? ' ' : '\n');
+        }
+    }
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+void writeMultigraphs(std::ostream& output, const std::vector<core::Multigraph>& multigraphs) {
+    output << multigraphs.size() << "\n";
+    for (std::size_t i = 0; i < multigraphs.size(); i++) {
+        if (i > 0) output << "\n";
+        writeMultigraph(output, multigraphs[i]);
+    }
+}
+} // namespace generator
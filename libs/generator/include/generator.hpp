@@ -0,0 +1,61 @@
+#pragma once
+
+#include "core.hpp"
+#include "random_stream.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace generator
+{
+enum class Family {
+    // every ordered pair of distinct vertices is joined with probability `density`
+    ErdosRenyi,
+    // out-degrees follow a discrete power law with exponent `exponent`, targets are uniform
+    PowerLaw,
+    // Erdos-Renyi noise over a random Hamiltonian cycle whose arcs have multiplicity at least `k`
+    PlantedHamiltonian,
+    // `clusterCount` dense blocks (`density`) joined by sparse bridges (`bridgeDensity`)
+    Clustered,
+};
+
+Family parseFamily(const std::string& name);
+
+struct GeneratorParameters {
+    Family family = Family::ErdosRenyi;
+    std::size_t vertexCount = 10;
+    double density = 0.1;
+    // multiplicities of generated arcs are uniform in [1, maxMultiplicity]
+    std::size_t maxMultiplicity = 1;
+    double exponent = 2.5;
+    std::size_t k = 1;
+    std::size_t clusterCount = 4;
+    double bridgeDensity = 0.01;
+};
+
+// Seeded multigraph generator. Graph i of a sequence and row r of that graph draw from their own split stream, so
+// the output depends only on the parameters and the seed, never on the number of threads.
+class Generator {
+  private:
+    GeneratorParameters _parameters;
+    RandomStream _root;
+    unsigned int _threads;
+
+    void generateRow(vertex u, RandomStream& stream, const std::vector<vertex>& successor,
+                     const std::vector<std::uint64_t>& degreeDistribution, core::multiplicity* row) const;
+
+  public:
+    // threads = 0 uses every hardware thread
+    Generator(const GeneratorParameters& parameters, std::uint64_t seed, unsigned int threads = 1);
+
+    core::Multigraph generate(std::size_t index) const;
+    std::vector<core::Multigraph> generate(std::size_t first, std::size_t count) const;
+};
+
+// Writes the graphs in the input format read by the CLI, preceded by their count.
+void writeMultigraphs(std::ostream& output, const std::vector<core::Multigraph>& multigraphs);
+// Writes a single graph block of the input format, without the leading graph count.
+void writeMultigraph(std::ostream& output, const core::Multigraph& multigraph);
+} // namespace generator
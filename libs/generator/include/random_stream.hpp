@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace generator
+{
+// xoshiro256** pseudo-random stream. Only integer arithmetic is used, so a given seed yields the same sequence on
+// every platform and compiler. Independent streams are derived with split() instead of sharing one generator
+// between threads.
+class RandomStream {
+  private:
+    std::uint64_t _state[4];
+
+  public:
+    explicit RandomStream(std::uint64_t seed);
+
+    std::uint64_t next();
+    // uniform integer in [0, bound), bound > 0
+    std::uint64_t uniform(std::uint64_t bound);
+    // uniform real number in [0, 1)
+    double uniformReal();
+    // true with the given probability
+    bool bernoulli(double probability);
+    // stream number `stream` derived from the current state, the state itself is left unchanged
+    RandomStream split(std::uint64_t stream) const;
+};
+} // namespace generator
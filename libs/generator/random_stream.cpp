@@ -0,0 +1,62 @@
+#include "random_stream.hpp"
+#include <limits>
+
+namespace generator
+{
+static std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static std::uint64_t rotateLeft(std::uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+RandomStream::RandomStream(std::uint64_t seed) {
+    for (auto& word : _state) {
+        word = splitMix64(seed);
+    }
+}
+
+std::uint64_t RandomStream::next() {
+    const std::uint64_t result = rotateLeft(_state[1] * 5, 7) * 9;
+    const std::uint64_t t = _state[1] << 17;
+
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = rotateLeft(_state[3], 45);
+
+    return result;
+}
+
+std::uint64_t RandomStream::uniform(std::uint64_t bound) {
+    // reject the low values that would make the modulo biased
+    const std::uint64_t threshold = (0 - bound) % bound;
+    for (;;) {
+        std::uint64_t value = next();
+        if (value >= threshold) return value % bound;
+    }
+}
+
+double RandomStream::uniformReal() {
+    return static_cast<double>(next() >> 11) * 0x1.0p-53;
+}
+
+bool RandomStream::bernoulli(double probability) {
+    if (probability >= 1.0) return true;
+    if (probability <= 0.0) return false;
+    // scaling by a power of two is exact, so the threshold is the same on every platform
+    return next() < static_cast<std::uint64_t>(probability * 0x1.0p64);
+}
+
+RandomStream RandomStream::split(std::uint64_t stream) const {
+    std::uint64_t seed = _state[0] ^ rotateLeft(_state[1], 17) ^ rotateLeft(_state[2], 31) ^ rotateLeft(_state[3], 47);
+    std::uint64_t streamSeed = stream;
+    return RandomStream(seed ^ splitMix64(streamSeed));
+}
+} // namespace generator
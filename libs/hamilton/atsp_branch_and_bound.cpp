@@ -0,0 +1,306 @@
+#include "include/atsp_branch_and_bound.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace hamilton
+{
+ATSPBranchAndBound::ATSPBranchAndBound(const Matrix& cost_matrix, const std::vector<std::size_t>& tour)
+    : n_(cost_matrix.size()), included_(cost_matrix.size(), false) {
+    if (n_ < 2) {
+        throw std::runtime_error("No valid ATSP cycle exists");
+    }
+
+    const std::size_t INF = std::numeric_limits<std::size_t>::max();
+    std::size_t max_cost = 0;
+    for (std::size_t u = 0; u < n_; ++u) {
+        for (std::size_t v = 0; v < n_; ++v) {
+            if (u != v && cost_matrix[u][v] != INF) max_cost = std::max(max_cost, cost_matrix[u][v]);
+        }
+    }
+    // an assignment may use n forbidden arcs, its cost has to fit the signed potentials of the assignment solver
+    if (max_cost > static_cast<std::size_t>(std::numeric_limits<std::int64_t>::max()) / (n_ * n_ + n_) - 1) {
+        throw std::invalid_argument("Arc costs too large for branch and bound");
+    }
+    forbidden_ = n_ * max_cost + 1;
+
+    base_costs_.resize(n_ * n_);
+    for (std::size_t u = 0; u < n_; ++u) {
+        for (std::size_t v = 0; v < n_; ++v) {
+            const bool missing = u == v || cost_matrix[u][v] == INF;
+            base_costs_[u * n_ + v] = missing ? forbidden_ : cost_matrix[u][v];
+        }
+    }
+    costs_ = base_costs_;
+
+    best_cost_ = forbidden_;
+    if (tour.size() == n_) {
+        std::vector<std::size_t> successor(n_);
+        for (std::size_t i = 0; i < n_; ++i) {
+            successor[tour[i]] = tour[(i + 1) % n_];
+        }
+        offer(successor);
+    }
+}
+
+std::size_t ATSPBranchAndBound::nodes() const {
+    return nodes_;
+}
+
+std::size_t ATSPBranchAndBound::assign(std::vector<std::size_t>& successor) {
+    ++nodes_;
+    const std::size_t cost = assignment_solver_.solve(costs_, n_);
+    successor = assignment_solver_.assignment();
+    return cost;
+}
+
+void ATSPBranchAndBound::exclude(std::size_t from, std::size_t to) {
+    const std::size_t index = from * n_ + to;
+    if (costs_[index] == forbidden_) return;
+    undo_log_.emplace_back(index, costs_[index]);
+    costs_[index] = forbidden_;
+}
+
+void ATSPBranchAndBound::include(std::size_t from, std::size_t to) {
+    for (std::size_t v = 0; v < n_; ++v) {
+        if (v != to) exclude(from, v);
+        if (v != from) exclude(v, to);
+    }
+    included_[from] = true;
+    undo_log_.emplace_back(n_ * n_ + from, 0);
+}
+
+void ATSPBranchAndBound::constrain(const Arcs& arcs, std::size_t branch) {
+    for (std::size_t g = 0; g < branch; ++g) {
+        include(arcs[g].first, arcs[g].second);
+    }
+    exclude(arcs[branch].first, arcs[branch].second);
+}
+
+void ATSPBranchAndBound::rollback(std::size_t checkpoint) {
+    while (undo_log_.size() > checkpoint) {
+        const auto [index, cost] = undo_log_.back();
+        undo_log_.pop_back();
+        if (index >= n_ * n_) {
+            included_[index - n_ * n_] = false;
+        } else {
+            costs_[index] = cost;
+        }
+    }
+}
+
+std::size_t ATSPBranchAndBound::tour_cost(const std::vector<std::size_t>& successor) const {
+    std::size_t cost = 0;
+    for (std::size_t u = 0; u < n_; ++u) {
+        const std::size_t arc = base_costs_[u * n_ + successor[u]];
+        if (arc == forbidden_) return forbidden_;
+        cost += arc;
+    }
+    return cost;
+}
+
+std::size_t ATSPBranchAndBound::best_cost() const {
+    return shared_best_cost_ ? std::min(best_cost_, shared_best_cost_->load(std::memory_order_relaxed)) : best_cost_;
+}
+
+void ATSPBranchAndBound::offer(const std::vector<std::size_t>& successor) {
+    const std::size_t cost = tour_cost(successor);
+    if (cost < best_cost_) {
+        best_cost_ = cost;
+        best_successor_ = successor;
+    }
+    if (!shared_best_cost_) return;
+    std::size_t current = shared_best_cost_->load(std::memory_order_relaxed);
+    while (cost < current && !shared_best_cost_->compare_exchange_weak(current, cost, std::memory_order_relaxed)) {
+    }
+}
+
+void ATSPBranchAndBound::patch(std::vector<std::size_t> successor,
+                               const std::vector<std::vector<std::size_t>>& cycles) {
+    std::vector<std::size_t> order(cycles.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [&](std::size_t a, std::size_t b) { return cycles[a].size() > cycles[b].size(); });
+
+    // the largest cycle absorbs the others: arcs u -> su of the tour and w -> sw of the cycle become u -> sw, w -> su
+    std::vector<std::size_t> tour = cycles[order[0]];
+    for (std::size_t c = 1; c < order.size(); ++c) {
+        std::int64_t best_delta = std::numeric_limits<std::int64_t>::max();
+        std::size_t best_u = n_, best_w = n_;
+        for (const std::size_t u : tour) {
+            for (const std::size_t w : cycles[order[c]]) {
+                const std::size_t su = successor[u], sw = successor[w];
+                const std::size_t into_cycle = base_costs_[u * n_ + sw], into_tour = base_costs_[w * n_ + su];
+                if (into_cycle == forbidden_ || into_tour == forbidden_) continue;
+                const std::int64_t delta =
+                    static_cast<std::int64_t>(into_cycle + into_tour) -
+                    static_cast<std::int64_t>(base_costs_[u * n_ + su] + base_costs_[w * n_ + sw]);
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_u = u;
+                    best_w = w;
+                }
+            }
+        }
+        if (best_u == n_) return;
+
+        std::swap(successor[best_u], successor[best_w]);
+        tour.insert(tour.end(), cycles[order[c]].begin(), cycles[order[c]].end());
+    }
+    offer(successor);
+}
+
+ATSPBranchAndBound::Arcs ATSPBranchAndBound::branch_arcs(const std::vector<std::size_t>& successor) {
+    std::vector<std::vector<std::size_t>> cycles;
+    std::vector<bool> seen(n_, false);
+    for (std::size_t start = 0; start < n_; ++start) {
+        if (seen[start]) continue;
+        cycles.emplace_back();
+        for (std::size_t v = start; !seen[v]; v = successor[v]) {
+            seen[v] = true;
+            cycles.back().push_back(v);
+        }
+    }
+    if (cycles.size() == 1) {
+        offer(successor);
+        return {};
+    }
+    patch(successor, cycles);
+
+    // branch on the subtour with the fewest arcs not fixed by the constraints; a subtour of included arcs only, left
+    // without free arcs, closes every completion
+    Arcs arcs;
+    bool chosen = false;
+    for (const auto& cycle : cycles) {
+        Arcs free_arcs;
+        for (const std::size_t v : cycle) {
+            if (!included_[v]) free_arcs.emplace_back(v, successor[v]);
+        }
+        if (!chosen || free_arcs.size() < arcs.size()) {
+            arcs = std::move(free_arcs);
+            chosen = true;
+        }
+    }
+    return arcs;
+}
+
+std::vector<ATSPBranchAndBound::Child> ATSPBranchAndBound::children(const Arcs& arcs) {
+    std::vector<Child> children;
+    for (std::size_t branch = 0; branch < arcs.size(); ++branch) {
+        const std::size_t checkpoint = undo_log_.size();
+        constrain(arcs, branch);
+        Child child{branch, 0, {}};
+        child.bound = assign(child.successor);
+        rollback(checkpoint);
+        if (child.bound < best_cost()) children.push_back(std::move(child));
+    }
+    std::stable_sort(children.begin(), children.end(),
+                     [](const Child& a, const Child& b) { return a.bound < b.bound; });
+    return children;
+}
+
+void ATSPBranchAndBound::search(const std::vector<std::size_t>& successor) {
+    const Arcs arcs = branch_arcs(successor);
+    if (arcs.empty()) return;
+
+    for (const auto& child : children(arcs)) {
+        if (child.bound >= best_cost()) break;
+        const std::size_t checkpoint = undo_log_.size();
+        constrain(arcs, child.branch);
+        search(child.successor);
+        rollback(checkpoint);
+    }
+}
+
+void ATSPBranchAndBound::search_parallel(const std::vector<std::size_t>& successor, std::size_t bound,
+                                         unsigned int threads) {
+    std::vector<Task> tasks{Task{{}, bound, successor}};
+    while (!tasks.empty() && tasks.size() < ATSP_BRANCH_AND_BOUND_TASKS_PER_THREAD * threads) {
+        std::vector<Task> next;
+        for (const auto& task : tasks) {
+            if (task.bound >= best_cost_) continue;
+            for (const auto& [arcs, branch] : task.branches) {
+                constrain(arcs, branch);
+            }
+            const Arcs arcs = branch_arcs(task.successor);
+            if (!arcs.empty()) {
+                for (auto& child : children(arcs)) {
+                    next.push_back(Task{task.branches, child.bound, std::move(child.successor)});
+                    next.back().branches.emplace_back(arcs, child.branch);
+                }
+            }
+            rollback(0);
+        }
+        tasks = std::move(next);
+    }
+    std::stable_sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return a.bound < b.bound; });
+
+    std::atomic<std::size_t> shared_best_cost{best_cost_};
+    std::vector<std::unique_ptr<ATSPBranchAndBound>> idle;
+    std::mutex idle_mutex;
+    core::parallelFor(tasks.size(), threads, [&](std::size_t i) {
+        std::unique_ptr<ATSPBranchAndBound> worker;
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            if (!idle.empty()) {
+                worker = std::move(idle.back());
+                idle.pop_back();
+            }
+        }
+        if (!worker) {
+            worker = std::make_unique<ATSPBranchAndBound>(*this);
+            worker->nodes_ = 0;
+            worker->shared_best_cost_ = &shared_best_cost;
+        }
+        if (tasks[i].bound < worker->best_cost()) {
+            for (const auto& [arcs, branch] : tasks[i].branches) {
+                worker->constrain(arcs, branch);
+            }
+            worker->search(tasks[i].successor);
+            worker->rollback(0);
+        }
+        std::lock_guard<std::mutex> lock(idle_mutex);
+        idle.push_back(std::move(worker));
+    });
+
+    // every worker keeps the best tour it found itself, the cheapest of them is the optimum
+    for (const auto& worker : idle) {
+        nodes_ += worker->nodes_;
+        if (worker->best_cost_ < best_cost_) {
+            best_cost_ = worker->best_cost_;
+            best_successor_ = worker->best_successor_;
+        }
+    }
+}
+
+std::vector<std::size_t> ATSPBranchAndBound::solve(unsigned int threads) {
+    nodes_ = 0;
+    std::vector<std::size_t> successor;
+    const std::size_t bound = assign(successor);
+    threads = core::resolveThreadCount(threads);
+    if (bound < best_cost_) {
+        if (threads <= 1) {
+            search(successor);
+        } else {
+            search_parallel(successor, bound, threads);
+        }
+    }
+
+    if (best_cost_ >= forbidden_) {
+        throw std::runtime_error("No valid ATSP cycle exists");
+    }
+
+    std::vector<std::size_t> tour{0};
+    for (std::size_t v = best_successor_[0]; v != 0; v = best_successor_[v]) {
+        tour.push_back(v);
+    }
+    return tour;
+}
+
+} // namespace hamilton
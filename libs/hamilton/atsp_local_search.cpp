@@ -0,0 +1,169 @@
+#include "include/atsp_local_search.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace hamilton
+{
+ATSPLocalSearch::ATSPLocalSearch(const Matrix& cost_matrix, std::size_t neighbours)
+    : cost_matrix_(cost_matrix), n_(cost_matrix.size()), penalty_(1),
+      neighbours_(std::min(neighbours, n_ == 0 ? 0 : n_ - 1)) {
+    std::int64_t max_cost = 0;
+    for (std::size_t u = 0; u < n_; ++u) {
+        for (std::size_t v = 0; v < n_; ++v) {
+            if (u != v && cost_matrix_[u][v] != std::numeric_limits<std::size_t>::max()) {
+                max_cost = std::max(max_cost, static_cast<std::int64_t>(cost_matrix_[u][v]));
+            }
+        }
+    }
+    penalty_ = static_cast<std::int64_t>(n_) * max_cost + 1;
+
+    successors_.resize(n_ * neighbours_);
+    predecessors_.resize(n_ * neighbours_);
+    std::vector<std::pair<std::int64_t, std::size_t>> candidates;
+    for (std::size_t u = 0; u < n_; ++u) {
+        for (const bool outgoing : {true, false}) {
+            candidates.clear();
+            for (std::size_t v = 0; v < n_; ++v) {
+                if (v != u) candidates.emplace_back(outgoing ? cost(u, v) : cost(v, u), v);
+            }
+            std::partial_sort(candidates.begin(), candidates.begin() + neighbours_, candidates.end());
+            auto& list = outgoing ? successors_ : predecessors_;
+            for (std::size_t i = 0; i < neighbours_; ++i) {
+                list[u * neighbours_ + i] = candidates[i].second;
+            }
+        }
+    }
+}
+
+std::int64_t ATSPLocalSearch::tour_cost(const std::vector<std::size_t>& tour) const {
+    std::int64_t total = 0;
+    for (std::size_t i = 0; i < tour.size(); ++i) {
+        total += cost(tour[i], tour[(i + 1) % tour.size()]);
+    }
+    return total;
+}
+
+void ATSPLocalSearch::improve(std::vector<std::size_t>& tour) {
+    improve(tour, tour);
+}
+
+void ATSPLocalSearch::improve(std::vector<std::size_t>& tour, const std::vector<std::size_t>& active) {
+    if (n_ < 3) return;
+
+    tour_ = tour;
+    position_.assign(n_, 0);
+    for (std::size_t i = 0; i < n_; ++i) {
+        position_[tour_[i]] = i;
+    }
+    queue_.clear();
+    queued_.assign(n_, false);
+    for (const std::size_t v : active) {
+        activate(v);
+    }
+
+    while (!queue_.empty()) {
+        const std::size_t v = queue_.front();
+        queue_.pop_front();
+        queued_[v] = false;
+        // a move activates the endpoints of the arcs it changes, v among them
+        if (!improve_or3opt(v)) improve_or_opt(v);
+    }
+
+    // keep the tour starting where it started
+    const auto start = std::find(tour_.begin(), tour_.end(), tour.front());
+    std::rotate_copy(tour_.begin(), start, tour_.end(), tour.begin());
+}
+
+void ATSPLocalSearch::activate(std::size_t v) {
+    if (queued_[v]) return;
+    queued_[v] = true;
+    queue_.push_back(v);
+}
+
+void ATSPLocalSearch::move(std::size_t x, std::size_t y, std::size_t z) {
+    const std::size_t x_next = succ(x), y_next = succ(y), z_next = succ(z);
+
+    // with segments A = succ(x)..y, B = succ(y)..z and C = succ(z)..x around the cycle, the new tour is B A C, which
+    // is also A C B and C B A: swap whichever two adjacent segments are shortest
+    const std::size_t a = offset(x, y), b = offset(x, z) - a, c = n_ - a - b;
+    const std::size_t start = position_[x] + 1;
+    if (a + b <= b + c && a + b <= c + a) {
+        swap_segments(start, a, b);
+    } else if (b + c <= c + a) {
+        swap_segments(start + a, b, c);
+    } else {
+        swap_segments(start + a + b, c, a);
+    }
+
+    for (const std::size_t v : {x, y, z, x_next, y_next, z_next}) {
+        activate(v);
+    }
+}
+
+void ATSPLocalSearch::swap_segments(std::size_t start, std::size_t first, std::size_t second) {
+    buffer_.resize(first + second);
+    for (std::size_t i = 0; i < first + second; ++i) {
+        buffer_[i] = tour_[(start + i) % n_];
+    }
+    std::rotate(buffer_.begin(), buffer_.begin() + first, buffer_.end());
+    for (std::size_t i = 0; i < first + second; ++i) {
+        const std::size_t position = (start + i) % n_;
+        tour_[position] = buffer_[i];
+        position_[buffer_[i]] = position;
+    }
+}
+
+bool ATSPLocalSearch::improve_or3opt(std::size_t x) {
+    const std::size_t x_next = succ(x);
+    const std::int64_t x_arc = cost(x, x_next);
+    for (std::size_t i = 0; i < neighbours_; ++i) {
+        // new arc x -> y_next
+        const std::size_t y_next = successors_[x * neighbours_ + i];
+        const std::int64_t first_gain = x_arc - cost(x, y_next);
+        if (first_gain <= 0) break;
+        if (y_next == x_next) continue;
+
+        const std::size_t y = pred(y_next);
+        const std::size_t y_offset = offset(x, y);
+        const std::int64_t y_arc = cost(y, y_next);
+        for (std::size_t j = 0; j < neighbours_; ++j) {
+            // new arc y -> z_next, z_next has to lie after y_next up to x
+            const std::size_t z_next = successors_[y * neighbours_ + j];
+            const std::int64_t second_gain = first_gain + y_arc - cost(y, z_next);
+            if (second_gain <= 0) break;
+            const std::size_t z_next_offset = z_next == x ? n_ : offset(x, z_next);
+            if (z_next_offset < y_offset + 2) continue;
+
+            const std::size_t z = pred(z_next);
+            if (second_gain + cost(z, z_next) - cost(z, x_next) > 0) {
+                move(x, y, z);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ATSPLocalSearch::improve_or_opt(std::size_t first) {
+    const std::size_t before = pred(first);
+    std::size_t last = first;
+    for (std::size_t length = 1; length <= 3 && length + 2 <= n_; ++length, last = succ(last)) {
+        const std::size_t after = succ(last);
+        const std::int64_t removal_gain = cost(before, first) + cost(last, after) - cost(before, after);
+        // the segment goes between a and succ(a), anywhere but where it is
+        auto try_insert = [&](std::size_t a) {
+            if (offset(before, a) <= length) return false;
+            const std::size_t b = succ(a);
+            if (removal_gain + cost(a, b) - cost(a, first) - cost(last, b) <= 0) return false;
+            move(before, last, a);
+            return true;
+        };
+        for (std::size_t i = 0; i < neighbours_; ++i) {
+            if (try_insert(predecessors_[first * neighbours_ + i])) return true;
+            if (try_insert(pred(successors_[last * neighbours_ + i]))) return true;
+        }
+    }
+    return false;
+}
+
+} // namespace hamilton
@@ -0,0 +1,163 @@
+#include "include/atsp_reduction.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace hamilton
+{
+ATSPReduction::ATSPReduction(const Matrix& cost_matrix)
+    : cost_matrix_(cost_matrix), n_(cost_matrix.size()), next_(n_, n_), heads_(n_), tails_(n_) {
+    std::iota(heads_.begin(), heads_.end(), 0);
+    std::iota(tails_.begin(), tails_.end(), 0);
+    while (heads_.size() > 1 && contract()) {
+    }
+
+    const std::size_t m = heads_.size();
+    reduced_.assign(m, std::vector<std::size_t>(m));
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < m; ++j) {
+            reduced_[i][j] = cost(i, j);
+        }
+    }
+}
+
+const ATSPReduction::Matrix& ATSPReduction::reduced() const {
+    return reduced_;
+}
+
+ATSPReduction::Matrix ATSPReduction::expand(const Matrix& reduced_cycle) const {
+    Matrix cycle(n_, std::vector<std::size_t>(n_, 0));
+    for (std::size_t i = 0; i < reduced_cycle.size(); ++i) {
+        for (std::size_t j = 0; j < reduced_cycle.size(); ++j) {
+            if (reduced_cycle[i][j] != 0) cycle[tails_[i]][heads_[j]] = reduced_cycle[i][j];
+        }
+    }
+    for (std::size_t v = 0; v < n_; ++v) {
+        if (next_[v] != n_) cycle[v][next_[v]] = cost_matrix_[v][next_[v]];
+    }
+    return cycle;
+}
+
+std::vector<std::size_t> ATSPReduction::reduce_tour(const std::vector<std::size_t>& tour) const {
+    std::vector<std::size_t> position(n_);
+    for (std::size_t i = 0; i < tour.size(); ++i) {
+        position[tour[i]] = i;
+    }
+    std::vector<std::size_t> order(heads_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](std::size_t a, std::size_t b) { return position[heads_[a]] < position[heads_[b]]; });
+    return order;
+}
+
+bool ATSPReduction::contract() {
+    const std::size_t INF = std::numeric_limits<std::size_t>::max();
+    const std::size_t m = heads_.size();
+    const std::size_t NONE = m;
+
+    // the two most expensive arcs into every chain and out of every chain, so that the maximum without any one arc
+    // is at hand
+    std::size_t cheapest = INF;
+    std::vector<std::size_t> column_first(m, 0), column_second(m, 0), column_arg(m, NONE);
+    std::vector<std::size_t> row_first(m, 0), row_second(m, 0), row_arg(m, NONE);
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < m; ++j) {
+            if (i == j) continue;
+            const std::size_t c = cost(i, j);
+            cheapest = std::min(cheapest, c);
+            if (column_arg[j] == NONE || c > column_first[j]) {
+                column_second[j] = column_first[j];
+                column_first[j] = c;
+                column_arg[j] = i;
+            } else {
+                column_second[j] = std::max(column_second[j], c);
+            }
+            if (row_arg[i] == NONE || c > row_first[i]) {
+                row_second[i] = row_first[i];
+                row_first[i] = c;
+                row_arg[i] = j;
+            } else {
+                row_second[i] = std::max(row_second[i], c);
+            }
+        }
+    }
+
+    // arcs out of i cheaper than another arc into their end, and arcs into j cheaper than another arc out of their
+    // start: the first condition allows at most one of them, leaving i towards j, the second at most one, entering j
+    // from i. The count stops at two, the last one found is kept.
+    std::vector<std::size_t> cheap_out(m, 0), cheap_out_end(m, NONE), cheap_in(m, 0), cheap_in_start(m, NONE);
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < m; ++j) {
+            if (i == j) continue;
+            const std::size_t c = cost(i, j);
+            if (c < (column_arg[j] == i ? column_second[j] : column_first[j])) {
+                cheap_out[i] = std::min<std::size_t>(cheap_out[i] + 1, 2);
+                cheap_out_end[i] = j;
+            }
+            if (c < (row_arg[i] == j ? row_second[i] : row_first[i])) {
+                cheap_in[j] = std::min<std::size_t>(cheap_in[j] + 1, 2);
+                cheap_in_start[j] = i;
+            }
+        }
+    }
+
+    if (cheapest == INF) return false;
+    const bool any_candidate = std::any_of(cheap_out.begin(), cheap_out.end(), [](std::size_t c) { return c < 2; }) ||
+                               std::any_of(cheap_in.begin(), cheap_in.end(), [](std::size_t c) { return c < 2; });
+    if (!any_candidate) return false;
+
+    auto passes = [&](std::size_t i, std::size_t j) {
+        if (cheap_out[i] == 0 || (cheap_out[i] == 1 && cheap_out_end[i] == j)) {
+            bool dominated = true;
+            for (std::size_t b = 0; b < m && dominated; ++b) {
+                if (b != i && b != j && cost(b, i) > cost(b, j)) dominated = false;
+            }
+            if (dominated) return true;
+        }
+        if (cheap_in[j] == 0 || (cheap_in[j] == 1 && cheap_in_start[j] == i)) {
+            bool dominated = true;
+            for (std::size_t a = 0; a < m && dominated; ++a) {
+                if (a != i && a != j && cost(j, a) > cost(i, a)) dominated = false;
+            }
+            if (dominated) return true;
+        }
+        return false;
+    };
+
+    // arcs chosen in this pass join the chains into paths, start_of[e] and end_of[s] link the ends of each path
+    std::vector<std::size_t> successor(m, NONE), predecessor(m, NONE);
+    std::vector<std::size_t> start_of(m), end_of(m);
+    std::iota(start_of.begin(), start_of.end(), 0);
+    std::iota(end_of.begin(), end_of.end(), 0);
+    bool contracted = false;
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < m && successor[i] == NONE; ++j) {
+            if (j == i || predecessor[j] != NONE || j == start_of[i] || cost(i, j) != cheapest) continue;
+            if (!passes(i, j)) continue;
+            successor[i] = j;
+            predecessor[j] = i;
+            const std::size_t start = start_of[i];
+            const std::size_t end = end_of[j];
+            end_of[start] = end;
+            start_of[end] = start;
+            contracted = true;
+        }
+    }
+    if (!contracted) return false;
+
+    std::vector<std::size_t> heads, tails;
+    for (std::size_t i = 0; i < m; ++i) {
+        if (predecessor[i] != NONE) continue;
+        std::size_t j = i;
+        for (; successor[j] != NONE; j = successor[j]) {
+            next_[tails_[j]] = heads_[successor[j]];
+        }
+        heads.push_back(heads_[i]);
+        tails.push_back(tails_[j]);
+    }
+    heads_ = std::move(heads);
+    tails_ = std::move(tails);
+    return true;
+}
+} // namespace hamilton
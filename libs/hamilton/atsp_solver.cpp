@@ -1,11 +1,22 @@
 #include "include/atsp_solver.hpp"
+#include "include/atsp_branch_and_bound.hpp"
+#include "include/atsp_local_search.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
 #include <utility>
 
 namespace hamilton
 {
-ATSPSolver::ATSPSolver(const Matrix& cost_matrix) : cost_matrix_(cost_matrix), n_(cost_matrix.size()) {
+ATSPSolver::ATSPSolver(Matrix cost_matrix) : cost_matrix_(std::move(cost_matrix)), n_(cost_matrix_.size()) {
     if (n_ == 0 || cost_matrix_.size() != cost_matrix_[0].size()) {
         throw std::invalid_argument("Cost matrix must be square and non-empty");
     }
@@ -20,70 +31,363 @@ ATSPSolver::Matrix ATSPSolver::reconstruct_cycle(const std::vector<std::size_t>&
     return result;
 }
 
-ATSPSolver::Matrix ATSPSolver::solve() {
+std::size_t ATSPSolver::max_arc_cost() const {
     const std::size_t INF = std::numeric_limits<std::size_t>::max();
+    std::size_t max_cost = 0;
+    for (std::size_t u = 0; u < n_; ++u) {
+        for (std::size_t v = 0; v < n_; ++v) {
+            if (u != v && cost_matrix_[u][v] != INF) max_cost = std::max(max_cost, cost_matrix_[u][v]);
+        }
+    }
+    return max_cost;
+}
 
-    // dp[mask][i] stores the minimal cost to visit nodes in `mask` ending at `i`
-    std::vector<std::vector<std::size_t>> dp(1U << n_, std::vector<std::size_t>(n_, INF));
+// Paths start at vertex 0, so it is left out of the masks: with m = n - 1 the table holds dp[mask][v - 1], the minimal
+// cost of a path from 0 through exactly the vertices of `mask` ending at v, for all 2^m masks in one buffer. Every
+// entry is pulled from the masks with one vertex less, so the masks of one popcount only read the previous layer and
+// each writes its own row. A layer is cut into runs of consecutive masks in colex order, a worker unranks the first
+// mask of its run and steps through the rest, and no two workers ever touch the same entry.
+template <typename Cost> std::vector<std::size_t> ATSPSolver::held_karp(unsigned int threads) const {
+    const std::size_t m = n_ - 1;
+    const Cost INF = std::numeric_limits<Cost>::max();
 
-    // for path reconstruction
-    std::vector<std::vector<int>> parent(1U << n_, std::vector<int>(n_, -1));
+    // arc[(v - 1) * n + u] is the cost of u -> v in the narrow type, so the arcs into v are contiguous
+    std::vector<Cost> arc(m * n_);
+    for (std::size_t v = 1; v < n_; ++v) {
+        for (std::size_t u = 0; u < n_; ++u) {
+            const std::size_t cost = cost_matrix_[u][v];
+            arc[(v - 1) * n_ + u] = cost == std::numeric_limits<std::size_t>::max() ? INF : static_cast<Cost>(cost);
+        }
+    }
+    auto arc_into = [&](std::size_t v) { return arc.data() + (v - 1) * n_; };
 
-    // start from the first node
-    dp[1][0] = 0;
+    // binomial[a][b] = a choose b, the rank of a mask among those of its popcount is the sum of binomial[c][i] over
+    // its i-th lowest set bit c
+    std::vector<std::vector<std::size_t>> binomial(m + 1, std::vector<std::size_t>(m + 1, 0));
+    for (std::size_t a = 0; a <= m; ++a) {
+        binomial[a][0] = 1;
+        for (std::size_t b = 1; b <= a; ++b) {
+            binomial[a][b] = binomial[a - 1][b - 1] + (b < a ? binomial[a - 1][b] : 0);
+        }
+    }
+    auto unrank = [&](std::size_t rank, std::size_t popcount) {
+        Mask mask = 0;
+        std::size_t c = m;
+        for (std::size_t i = popcount; i > 0; --i) {
+            do {
+                --c;
+            } while (binomial[c][i] > rank);
+            mask |= Mask(1) << c;
+            rank -= binomial[c][i];
+        }
+        return mask;
+    };
+    // next mask of the same popcount in increasing (colex) order
+    auto next_mask = [](Mask mask) {
+        const Mask filled = mask | (mask - 1);
+        return (filled + 1) | (((~filled & (filled + 1)) - 1) >> (std::countr_zero(mask) + 1));
+    };
 
-    // fill the table
-    for (std::size_t mask = 1; mask < (1U << n_); ++mask) {
-        for (std::size_t u = 0; u < n_; ++u) {
-            if (!(mask & (1U << u)) || dp[mask][u] == INF) continue;
+    // every entry a layer reads is written by the layer before, the rest are never read and stay uninitialized, so
+    // each page is first touched by the worker filling it
+    const Mask full = (Mask(1) << m) - 1;
+    const auto dp = std::make_unique_for_overwrite<Cost[]>((static_cast<std::size_t>(full) + 1) * m);
+    auto row = [&](Mask mask) { return dp.get() + static_cast<std::size_t>(mask) * m; };
 
-            for (std::size_t v = 0; v < n_; ++v) {
-                if (mask & (1U << v) || cost_matrix_[u][v] == INF) continue;
+    auto relax = [&](Mask mask) {
+        Cost* current = row(mask);
+        for (Mask ends = mask; ends != 0; ends &= ends - 1) {
+            const std::size_t v = std::countr_zero(ends) + 1;
+            const Mask prev = mask & ~(Mask(1) << (v - 1));
+            const Cost* into_v = arc_into(v);
+            if (prev == 0) {
+                current[v - 1] = into_v[0];
+                continue;
+            }
 
-                std::size_t new_mask = mask | (1U << v);
-                std::size_t new_cost = dp[mask][u] + cost_matrix_[u][v];
+            const Cost* previous = row(prev);
+            Cost best = INF;
+            for (Mask rest = prev; rest != 0; rest &= rest - 1) {
+                const std::size_t u = std::countr_zero(rest) + 1;
+                if (previous[u - 1] == INF || into_v[u] == INF) continue;
+                best = std::min(best, static_cast<Cost>(previous[u - 1] + into_v[u]));
+            }
+            current[v - 1] = best;
+        }
+    };
 
-                if (new_cost < dp[new_mask][v]) {
-                    dp[new_mask][v] = new_cost;
-                    parent[new_mask][v] = static_cast<int>(u);
-                }
+    for (std::size_t popcount = 1; popcount <= m; ++popcount) {
+        const std::size_t layer = binomial[m][popcount];
+        const std::size_t runs = (layer + HELD_KARP_RUN_LENGTH - 1) / HELD_KARP_RUN_LENGTH;
+        core::parallelFor(runs, threads, [&](std::size_t run) {
+            const std::size_t begin = run * HELD_KARP_RUN_LENGTH;
+            const std::size_t end = std::min(layer, begin + HELD_KARP_RUN_LENGTH);
+            Mask mask = unrank(begin, popcount);
+            for (std::size_t rank = begin; rank < end; ++rank, mask = next_mask(mask)) {
+                relax(mask);
             }
+        });
+    }
+
+    // close the cycle back to vertex 0
+    std::size_t optimal_cost = std::numeric_limits<std::size_t>::max();
+    std::size_t last_node = 0;
+    for (std::size_t v = 1; v < n_; ++v) {
+        const Cost to_end = row(full)[v - 1];
+        const std::size_t back = cost_matrix_[v][0];
+        if (to_end == INF || back == std::numeric_limits<std::size_t>::max()) continue;
+        if (to_end + back < optimal_cost) {
+            optimal_cost = to_end + back;
+            last_node = v;
         }
     }
 
-    // find the optimal end node
-    std::size_t optimal_cost = INF;
-    int last_node = -1;
+    if (last_node == 0) {
+        throw std::runtime_error("No valid ATSP cycle exists");
+    }
 
-    for (std::size_t i = 1; i < n_; ++i) {
-        std::size_t cost_to_complete = dp[(1U << n_) - 1][i] + cost_matrix_[i][0];
-        if (cost_to_complete < optimal_cost) {
-            optimal_cost = cost_to_complete;
-            last_node = static_cast<int>(i);
+    // walk the path backwards: the predecessor of v is any u whose entry plus the arc u -> v gives v's entry
+    std::vector<std::size_t> path{last_node};
+    Mask mask = full;
+    std::size_t current_node = last_node;
+    while (mask != (Mask(1) << (current_node - 1))) {
+        const Cost cost = row(mask)[current_node - 1];
+        const Mask prev = mask & ~(Mask(1) << (current_node - 1));
+        const Cost* previous = row(prev);
+        const Cost* into_current = arc_into(current_node);
+        std::size_t prev_node = 0;
+        for (Mask rest = prev; rest != 0; rest &= rest - 1) {
+            const std::size_t u = std::countr_zero(rest) + 1;
+            if (previous[u - 1] != INF && into_current[u] != INF && previous[u - 1] + into_current[u] == cost) {
+                prev_node = u;
+                break;
+            }
         }
+        path.push_back(prev_node);
+        mask = prev;
+        current_node = prev_node;
     }
+    path.push_back(0);
 
-    if (optimal_cost == INF) {
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+ATSPSolver::Matrix ATSPSolver::solve(unsigned int threads, ATSPEngine engine) {
+    if (engine == ATSPEngine::Auto) engine = prefers_held_karp() ? ATSPEngine::HeldKarp : ATSPEngine::BranchAndBound;
+    return engine == ATSPEngine::HeldKarp ? solve_held_karp(threads) : solve_branch_and_bound(threads);
+}
+
+ATSPSolver::Matrix ATSPSolver::solve_held_karp(unsigned int threads) {
+    if (n_ == 1) {
         throw std::runtime_error("No valid ATSP cycle exists");
     }
+    if (n_ - 1 >= std::numeric_limits<Mask>::digits) {
+        throw std::invalid_argument("Held-Karp supports at most 64 vertices");
+    }
 
-    // reconstruct the path
-    std::vector<std::size_t> path;
-    std::size_t mask = (1U << n_) - 1;
-    int current_node = last_node;
+    // a path visits at most n arcs, so the narrowest type holding n times the longest arc holds every entry, with its
+    // maximum left free to mark unreachable entries
+    const std::size_t bound = n_ * max_arc_cost();
+    if (bound < std::numeric_limits<std::uint16_t>::max()) return reconstruct_cycle(held_karp<std::uint16_t>(threads));
+    if (bound < std::numeric_limits<std::uint32_t>::max()) return reconstruct_cycle(held_karp<std::uint32_t>(threads));
+    return reconstruct_cycle(held_karp<std::size_t>(threads));
+}
 
-    while (current_node != -1) {
-        path.push_back(static_cast<std::size_t>(current_node));
-        int prev_node = parent[mask][current_node];
-        mask &= ~(1U << current_node);
-        current_node = prev_node;
+bool ATSPSolver::prefers_held_karp() const {
+    if (n_ <= HELD_KARP_ALWAYS_VERTICES) return true;
+    if (n_ > HELD_KARP_SPARSE_VERTICES) return false;
+
+    const std::size_t INF = std::numeric_limits<std::size_t>::max();
+    std::size_t cheapest_arcs = 0;
+    for (std::size_t u = 0; u < n_; ++u) {
+        std::size_t row_minimum = INF, count = 0;
+        for (std::size_t v = 0; v < n_; ++v) {
+            if (u == v || cost_matrix_[u][v] == INF) continue;
+            if (cost_matrix_[u][v] < row_minimum) {
+                row_minimum = cost_matrix_[u][v];
+                count = 0;
+            }
+            if (cost_matrix_[u][v] == row_minimum) ++count;
+        }
+        cheapest_arcs += count;
     }
+    return cheapest_arcs < 2 * n_;
+}
 
-    std::reverse(path.begin(), path.end());
-    return reconstruct_cycle(path);
+ATSPSolver::Matrix ATSPSolver::solve_branch_and_bound(unsigned int threads) {
+    if (n_ == 1) {
+        throw std::runtime_error("No valid ATSP cycle exists");
+    }
+
+    // an instance without a nearest neighbour tour may still have a tour
+    std::vector<std::size_t> incumbent;
+    try {
+        incumbent = approximate_tour();
+    } catch (const std::runtime_error&) {
+    }
+    return reconstruct_cycle(ATSPBranchAndBound(cost_matrix_, incumbent).solve(threads));
 }
 
 ATSPSolver::Matrix ATSPSolver::approximate() {
+    return reconstruct_cycle(approximate_tour());
+}
+
+void ATSPSolver::warm_start(std::vector<std::size_t> tour) {
+    std::vector<bool> seen(n_, false);
+    bool valid = tour.size() == n_;
+    for (std::size_t i = 0; i < tour.size() && valid; ++i) {
+        valid = tour[i] < n_ && !seen[tour[i]];
+        if (valid) seen[tour[i]] = true;
+    }
+    if (!valid) throw std::invalid_argument("Warm start tour must visit every vertex once");
+    warm_start_ = std::move(tour);
+}
+
+// nearest neighbour from a random vertex, each step going to one of the ATSP_RANDOMIZED_CHOICES cheapest unvisited
+// vertices at random, or to any unvisited vertex when no arc leads to one
+static std::vector<std::size_t> randomized_tour(const ATSPSolver::Matrix& cost_matrix, std::mt19937_64& random) {
+    const std::size_t n = cost_matrix.size();
+    std::vector<std::size_t> tour{std::uniform_int_distribution<std::size_t>(0, n - 1)(random)};
+    std::vector<bool> visited(n, false);
+    visited[tour[0]] = true;
+
+    std::vector<std::pair<std::size_t, std::size_t>> candidates;
+    std::vector<std::size_t> unvisited;
+    for (std::size_t step = 1; step < n; ++step) {
+        const std::size_t current = tour.back();
+        candidates.clear();
+        unvisited.clear();
+        for (std::size_t v = 0; v < n; ++v) {
+            if (visited[v]) continue;
+            unvisited.push_back(v);
+            if (cost_matrix[current][v] != std::numeric_limits<std::size_t>::max()) {
+                candidates.emplace_back(cost_matrix[current][v], v);
+            }
+        }
+
+        std::size_t next;
+        if (candidates.empty()) {
+            next = unvisited[std::uniform_int_distribution<std::size_t>(0, unvisited.size() - 1)(random)];
+        } else {
+            const std::size_t choices = std::min(ATSP_RANDOMIZED_CHOICES, candidates.size());
+            std::partial_sort(candidates.begin(), candidates.begin() + choices, candidates.end());
+            next = candidates[std::uniform_int_distribution<std::size_t>(0, choices - 1)(random)].second;
+        }
+        tour.push_back(next);
+        visited[next] = true;
+    }
+    return tour;
+}
+
+// cuts the tour into A B C D at three random points and reconnects it as A C B D, which keeps every arc direction;
+// returns the endpoints of the three replaced arcs
+static std::vector<std::size_t> double_bridge(std::vector<std::size_t>& tour, std::mt19937_64& random) {
+    std::vector<std::size_t> cuts(3);
+    do {
+        for (auto& cut : cuts) {
+            cut = std::uniform_int_distribution<std::size_t>(1, tour.size() - 1)(random);
+        }
+        std::sort(cuts.begin(), cuts.end());
+    } while (cuts[0] == cuts[1] || cuts[1] == cuts[2]);
+
+    std::vector<std::size_t> endpoints;
+    for (const std::size_t cut : cuts) {
+        endpoints.push_back(tour[cut - 1]);
+        endpoints.push_back(tour[cut]);
+    }
+    std::rotate(tour.begin() + cuts[0], tour.begin() + cuts[1], tour.begin() + cuts[2]);
+    return endpoints;
+}
+
+ATSPSolver::Matrix ATSPSolver::approximate(unsigned int threads, std::chrono::steady_clock::duration time_limit,
+                                           std::uint64_t seed, std::size_t iteration_limit) {
+    if (time_limit <= std::chrono::steady_clock::duration::zero() && iteration_limit == 0) {
+        throw std::invalid_argument("Multi-start search needs a time or an iteration limit");
+    }
+    if (n_ == 1) {
+        throw std::runtime_error("No valid ATSP cycle exists");
+    }
+
+    const auto deadline = time_limit > std::chrono::steady_clock::duration::zero()
+                              ? std::chrono::steady_clock::now() + time_limit
+                              : std::chrono::steady_clock::time_point::max();
+    const unsigned int workers = core::resolveThreadCount(threads);
+    // the candidate lists are built once and copied into every worker
+    const ATSPLocalSearch local_search(cost_matrix_);
+
+    std::mutex best_mutex;
+    std::int64_t best_cost = std::numeric_limits<std::int64_t>::max();
+    std::size_t best_worker = workers;
+    std::vector<std::size_t> best_tour;
+    auto publish = [&](std::size_t worker, const std::vector<std::size_t>& tour, std::int64_t cost) {
+        std::lock_guard<std::mutex> lock(best_mutex);
+        if (cost < best_cost || (cost == best_cost && worker < best_worker)) {
+            best_cost = cost;
+            best_worker = worker;
+            best_tour = tour;
+        }
+    };
+
+    core::parallelFor(workers, workers, [&](std::size_t worker) {
+        std::mt19937_64 random(seed + 0x9E3779B97F4A7C15ULL * (worker + 1));
+        ATSPLocalSearch search(local_search);
+        std::vector<std::size_t> current, candidate;
+        std::int64_t current_cost = 0;
+        std::size_t stall = 0;
+        auto start = [&](bool nearest_neighbour) {
+            current.clear();
+            if (nearest_neighbour) {
+                try {
+                    current = approximate_tour();
+                } catch (const std::runtime_error&) {
+                }
+            }
+            if (current.empty()) current = randomized_tour(cost_matrix_, random);
+            search.improve(current);
+            current_cost = search.tour_cost(current);
+            stall = 0;
+            publish(worker, current, current_cost);
+        };
+
+        // iteration i belongs to worker i mod workers
+        for (std::size_t iteration = worker; iteration_limit == 0 || iteration < iteration_limit;
+             iteration += workers) {
+            if (std::chrono::steady_clock::now() >= deadline) break;
+            // a double bridge needs four segments
+            if (current.empty() || stall >= ATSP_RESTART_STALL || n_ < 8) {
+                start(current.empty() && worker == 0);
+                continue;
+            }
+
+            candidate = current;
+            search.improve(candidate, double_bridge(candidate, random));
+            const std::int64_t candidate_cost = search.tour_cost(candidate);
+            if (candidate_cost > current_cost) {
+                ++stall;
+                continue;
+            }
+            stall = candidate_cost < current_cost ? 0 : stall + 1;
+            if (candidate_cost < current_cost) publish(worker, candidate, candidate_cost);
+            std::swap(current, candidate);
+            current_cost = candidate_cost;
+        }
+    });
+
+    // the time limit may pass before any worker built a tour
+    if (best_tour.empty()) best_tour = approximate_tour();
+    std::rotate(best_tour.begin(), std::find(best_tour.begin(), best_tour.end(), 0), best_tour.end());
+    return reconstruct_cycle(best_tour);
+}
+
+std::vector<std::size_t> ATSPSolver::approximate_tour() const {
+    ATSPLocalSearch local_search(cost_matrix_);
+    std::vector<std::size_t> warm_tour = warm_start_;
+    if (!warm_tour.empty()) {
+        std::rotate(warm_tour.begin(), std::find(warm_tour.begin(), warm_tour.end(), 0), warm_tour.end());
+        local_search.improve(warm_tour);
+    }
+
     // nearest-neighbor heuristic
     std::vector<std::size_t> path;
     std::vector<bool> visited(n_, false);
@@ -101,42 +405,17 @@ ATSPSolver::Matrix ATSPSolver::approximate() {
             }
         }
         if (nearest_neighbor == -1) {
+            if (!warm_tour.empty()) return warm_tour;
             throw std::runtime_error("No valid ATSP cycle exists");
         }
         current_node = nearest_neighbor;
         path.push_back(current_node);
         visited[current_node] = true;
     }
-    path.push_back(0);
-
-    // 2-Opt heuristic
-    std::size_t numImpr = 0;
-    std::size_t costForward, costReverse;
-    bool improvement = true;
-    while (numImpr < n_ && improvement) {
-        improvement = false;
-        for (std::size_t i = 1; i < path.size() - 2; ++i) {
-            costForward = 0;
-            costReverse = 0;
-
-            for (std::size_t j = i + 1; j < path.size() - 1; ++j) {
-                std::size_t cost_before =
-                    cost_matrix_[path[i - 1]][path[i]] + costForward + cost_matrix_[path[j]][path[j + 1]];
-                std::size_t cost_after =
-                    cost_matrix_[path[i - 1]][path[j]] + costReverse + cost_matrix_[path[i]][path[j + 1]];
-                if (cost_after < cost_before) {
-                    improvement = true;
-                    std::reverse(path.begin() + i, path.begin() + j + 1);
-                    std::swap(costForward, costReverse);
-                }
-                costForward += cost_matrix_[path[j]][path[j + 1]];
-                costReverse += cost_matrix_[path[j + 1]][path[j]];
-            }
-        }
-        numImpr++;
-    }
 
-    return reconstruct_cycle(path);
+    local_search.improve(path);
+    if (!warm_tour.empty() && local_search.tour_cost(warm_tour) < local_search.tour_cost(path)) return warm_tour;
+    return path;
 }
 
 } // namespace hamilton
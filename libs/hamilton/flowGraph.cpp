@@ -1,4 +1,3 @@
-#include <iostream>
 #include <vector>
 #include <queue>
 #include <limits>
@@ -7,55 +6,187 @@
 
 namespace hamilton
 {
-FlowGraph::FlowGraph(std::size_t n)
-    : vertexCount(n), capacity(n, std::vector<std::size_t>(n, 0)), flow(n, std::vector<std::size_t>(n, 0)) {
+FlowGraph::FlowGraph(std::size_t n, std::size_t edgeCount) : vertexCount(n), head_(n, NONE) {
+    reserveEdges(edgeCount);
+}
+
+void FlowGraph::reserveEdges(std::size_t edgeCount) {
+    to_.reserve(2 * edgeCount);
+    residual_.reserve(2 * edgeCount);
+    next_.reserve(2 * edgeCount);
 }
 
 void FlowGraph::addEdge(std::size_t u, std::size_t v, std::size_t cap) {
-    capacity[u][v] += cap;
+    to_.push_back(v);
+    residual_.push_back(cap);
+    next_.push_back(head_[u]);
+    head_[u] = to_.size() - 1;
+
+    to_.push_back(u);
+    residual_.push_back(0);
+    next_.push_back(head_[v]);
+    head_[v] = to_.size() - 1;
 }
 
-bool FlowGraph::bfs(std::size_t source, std::size_t sink, std::vector<std::size_t>& parent) {
-    std::vector<bool> visited(vertexCount, false);
-    std::queue<std::size_t> queue;
-    queue.push(source);
-    visited[source] = true;
+std::size_t FlowGraph::maxFlow(std::size_t source, std::size_t sink, FlowAlgorithm algorithm) {
+    return algorithm == FlowAlgorithm::PushRelabel ? pushRelabel(source, sink) : dinic(source, sink);
+}
 
-    while (!queue.empty()) {
-        std::size_t u = queue.front();
-        queue.pop();
+bool FlowGraph::bfs(std::size_t source, std::size_t sink) {
+    level_.assign(vertexCount, NONE);
+    path_.clear();
+    path_.push_back(source);
+    level_[source] = 0;
 
-        for (std::size_t v = 0; v < vertexCount; ++v) {
-            if (!visited[v] && capacity[u][v] - flow[u][v] > 0) {
-                queue.push(v);
-                visited[v] = true;
-                parent[v] = u;
-                if (v == sink) return true;
+    // vertices on the level of the sink or below it lead nowhere, so the search stops at the sink
+    for (std::size_t i = 0; i < path_.size(); ++i) {
+        std::size_t u = path_[i];
+        if (u == sink) break;
+        for (std::size_t e = head_[u]; e != NONE; e = next_[e]) {
+            std::size_t v = to_[e];
+            if (residual_[e] > 0 && level_[v] == NONE) {
+                level_[v] = level_[u] + 1;
+                path_.push_back(v);
             }
         }
     }
-    return false;
+    return level_[sink] != NONE;
 }
 
-std::size_t FlowGraph::edmondsKarp(std::size_t source, std::size_t sink) {
-    std::vector<std::size_t> parent(vertexCount);
-    std::size_t maxFlow = 0;
+std::size_t FlowGraph::blockingFlow(std::size_t source, std::size_t sink) {
+    // depth-first search along the levels, path_ holds the edges from the source to v and current_ the first edge of
+    // every vertex that may still lead to the sink
+    current_ = head_;
+    path_.clear();
+    std::size_t flow = 0;
+    std::size_t v = source;
+
+    while (true) {
+        if (v == sink) {
+            std::size_t pathFlow = INF;
+            for (std::size_t e : path_) {
+                pathFlow = std::min(pathFlow, residual_[e]);
+            }
+            for (std::size_t e : path_) {
+                push(e, pathFlow);
+            }
+            flow += pathFlow;
 
-    while (bfs(source, sink, parent)) {
-        std::size_t pathFlow = INF;
-        for (std::size_t v = sink; v != source; v = parent[v]) {
-            std::size_t u = parent[v];
-            pathFlow = std::min(pathFlow, capacity[u][v] - flow[u][v]);
+            // continue from the tail of the first saturated edge
+            std::size_t kept = 0;
+            while (residual_[path_[kept]] > 0) {
+                ++kept;
+            }
+            path_.resize(kept);
+            v = kept == 0 ? source : to_[path_.back()];
+            continue;
+        }
+
+        std::size_t e = current_[v];
+        while (e != NONE && (residual_[e] == 0 || level_[to_[e]] != level_[v] + 1)) {
+            e = next_[e];
         }
+        current_[v] = e;
+
+        if (e != NONE) {
+            path_.push_back(e);
+            v = to_[e];
+        } else if (v == source) {
+            return flow;
+        } else {
+            // v is a dead end, retreat and skip the edge that led to it
+            e = path_.back();
+            path_.pop_back();
+            v = tail(e);
+            current_[v] = next_[current_[v]];
+        }
+    }
+}
+
+std::size_t FlowGraph::dinic(std::size_t source, std::size_t sink) {
+    std::size_t flow = 0;
+    while (bfs(source, sink)) {
+        flow += blockingFlow(source, sink);
+    }
+    return flow;
+}
 
-        for (std::size_t v = sink; v != source; v = parent[v]) {
-            std::size_t u = parent[v];
-            flow[u][v] += pathFlow;
-            flow[v][u] -= pathFlow;
+std::size_t FlowGraph::pushRelabel(std::size_t source, std::size_t sink) {
+    const std::size_t n = vertexCount;
+    std::vector<std::size_t> excess(n, 0);
+    // vertices per height, heights stay below 2n
+    std::vector<std::size_t> count(2 * n, 0);
+    std::queue<std::size_t> active;
+    std::vector<std::size_t>& height = level_;
+    height.assign(n, 0);
+    height[source] = n;
+    count[0] = n - 1;
+    count[n] = 1;
+    current_ = head_;
+
+    // The source saturates its edges, but pushes no more into a vertex other than the sink than its edges can take on,
+    // so that unbounded capacities such as INF do not overflow the excess. No flow can pass a vertex beyond that.
+    for (std::size_t e = head_[source]; e != NONE; e = next_[e]) {
+        std::size_t v = to_[e];
+        if (v == source) continue;
+        std::size_t outgoing = v == sink ? INF : 0;
+        for (std::size_t f = head_[v]; f != NONE && v != sink; f = next_[f]) {
+            outgoing = residual_[f] > INF - outgoing ? INF : outgoing + residual_[f];
         }
+        std::size_t amount = std::min(residual_[e], outgoing);
+        if (amount == 0) continue;
+        push(e, amount);
+        if (excess[v] == 0 && v != sink) active.push(v);
+        excess[v] += amount;
+    }
+
+    while (!active.empty()) {
+        std::size_t v = active.front();
+        active.pop();
 
-        maxFlow += pathFlow;
+        // discharge v: push along admissible edges, relabel when none is left
+        while (excess[v] > 0) {
+            std::size_t e = current_[v];
+            if (e == NONE) {
+                std::size_t oldHeight = height[v];
+                std::size_t newHeight = 2 * n - 1;
+                for (std::size_t f = head_[v]; f != NONE; f = next_[f]) {
+                    if (residual_[f] > 0) newHeight = std::min(newHeight, height[to_[f]] + 1);
+                }
+                current_[v] = head_[v];
+                --count[oldHeight];
+
+                if (count[oldHeight] == 0 && oldHeight < n) {
+                    // gap: no vertex above the empty height and below the source reaches the sink any more, so all
+                    // of them may only return their excess to the source
+                    for (std::size_t u = 0; u < n; ++u) {
+                        if (u != source && height[u] > oldHeight && height[u] < n) {
+                            --count[height[u]];
+                            height[u] = n + 1;
+                            ++count[n + 1];
+                            current_[u] = head_[u];
+                        }
+                    }
+                    newHeight = std::max(newHeight, n + 1);
+                }
+                height[v] = newHeight;
+                ++count[newHeight];
+                continue;
+            }
+
+            std::size_t w = to_[e];
+            if (residual_[e] > 0 && height[v] == height[w] + 1) {
+                std::size_t amount = std::min(excess[v], residual_[e]);
+                push(e, amount);
+                excess[v] -= amount;
+                if (excess[w] == 0 && w != source && w != sink) active.push(w);
+                excess[w] += amount;
+            } else {
+                current_[v] = next_[e];
+            }
+        }
     }
-    return maxFlow;
+
+    return excess[sink];
 }
-} // namespace hamilton
\ No newline at end of file
+} // namespace hamilton
@@ -1,21 +1,27 @@
 #include "include/hamilton.hpp"
+#include "include/atsp_reduction.hpp"
 #include "include/atsp_solver.hpp"
 #include "include/flowGraph.hpp"
-#include <set>
+#include "parallel.hpp"
+#include <algorithm>
+#include <stdexcept>
 
 namespace hamilton
 {
-std::vector<std::vector<std::size_t>> findKHamiltonianExtension(std::size_t k, core::Multigraph multiGraph,
-                                                                bool approx) {
-    ATSPSolver::Matrix multiGraphAM = multiGraph.getAdjacencyMatrix();
-    ATSPSolver::Matrix cost(multiGraphAM);
-    for (int i = 0; i < cost.size(); ++i) {
-        for (int j = 0; j < cost[0].size(); ++j) {
-            if (i == j) continue;
-            if (multiGraphAM[i][j] == 0) {
+static ATSPSolver::Matrix extensionCosts(std::size_t k, const core::Multigraph& multiGraph) {
+    const auto multiGraphAM = multiGraph.view();
+    const std::size_t n = multiGraph.vertexCount();
+    ATSPSolver::Matrix cost(n, std::vector<std::size_t>(n));
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            if (i == j) {
+                cost[i][j] = multiGraphAM(i, j);
+                continue;
+            }
+            if (multiGraphAM(i, j) == 0) {
                 cost[i][j] = k;
-            } else if (k >= multiGraphAM[i][j]) {
-                cost[i][j] = k - multiGraphAM[i][j];
+            } else if (k >= multiGraphAM(i, j)) {
+                cost[i][j] = k - multiGraphAM(i, j);
             } else {
                 cost[i][j] = 0;
             }
@@ -24,15 +30,48 @@ std::vector<std::vector<std::size_t>> findKHamiltonianExtension(std::size_t k, c
             cost[i][j] += 1;
         }
     }
+    return cost;
+}
 
+// Solves the extension ATSP for one k. `tour` holds a tour to start from, or is empty, and is replaced by the vertex
+// order of the tour found.
+static std::vector<std::vector<std::size_t>> solveExtension(std::size_t k, const core::Multigraph& multiGraph,
+                                                            bool approx, unsigned int threads,
+                                                            std::chrono::steady_clock::duration timeLimit,
+                                                            std::uint64_t seed, ATSPEngine engine,
+                                                            std::vector<std::size_t>& tour) {
+    const std::size_t n = multiGraph.vertexCount();
+    const ATSPSolver::Matrix cost = extensionCosts(k, multiGraph);
     ATSPSolver::Matrix cycleMatrix;
 
     try {
-        ATSPSolver solver(cost);
-        cycleMatrix = approx ? solver.approximate() : solver.solve();
+        // forced stretches of k-arcs are contracted first, the solver only sees the chains they form
+        ATSPReduction reduction(cost);
+        ATSPSolver::Matrix reducedCycle;
+        if (reduction.reduced().size() == 1 && n > 1) {
+            reducedCycle = reduction.reduced();
+        } else {
+            ATSPSolver solver(reduction.reduced());
+            if (tour.size() == n) solver.warm_start(reduction.reduce_tour(tour));
+            if (!approx) {
+                reducedCycle = solver.solve(threads, engine);
+            } else if (timeLimit > std::chrono::steady_clock::duration::zero()) {
+                reducedCycle = solver.approximate(threads, timeLimit, seed);
+            } else {
+                reducedCycle = solver.approximate();
+            }
+        }
+        cycleMatrix = reduction.expand(reducedCycle);
 
-        for (int i = 0; i < cost.size(); ++i) {
-            for (int j = 0; j < cost[0].size(); ++j) {
+        // every arc costs at least 1, so the tour arcs are the nonzero entries
+        tour.assign(1, 0);
+        for (std::size_t step = 1; step < n; ++step) {
+            const auto& row = cycleMatrix[tour.back()];
+            tour.push_back(std::find_if(row.begin(), row.end(), [](std::size_t c) { return c != 0; }) - row.begin());
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
                 if (cycleMatrix[i][j] != 0) {
                     // ATSP algorithm can't handle 0 costs
                     cycleMatrix[i][j] -= 1;
@@ -41,112 +80,152 @@ std::vector<std::vector<std::size_t>> findKHamiltonianExtension(std::size_t k, c
         }
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
+        tour.clear();
     }
 
     return cycleMatrix;
 }
 
-void divideVertices(std::vector<std::vector<std::size_t>>& inputGraph, std::set<std::size_t>& X_in,
-                    std::set<std::size_t>& X_out, std::set<std::size_t>& Y,
-                    std::vector<std::vector<std::size_t>>& extensionMatrix) {
-    for (int i = 0; i < inputGraph.size(); ++i) {
-        for (int j = 0; j < inputGraph.size(); j++) {
-            if (extensionMatrix[i][j] != 0) {
-                X_out.insert(i);
-                X_in.insert(j);
-            }
-        }
-    }
-
-    for (int i = 0; i < inputGraph.size(); ++i) {
-        if (X_in.find(i) == X_in.end() && X_out.find(i) == X_out.end()) {
-            Y.insert(i);
-        }
-    }
+std::vector<std::vector<std::size_t>> findKHamiltonianExtension(std::size_t k, const core::Multigraph& multiGraph,
+                                                                bool approx, unsigned int threads,
+                                                                std::chrono::steady_clock::duration timeLimit,
+                                                                std::uint64_t seed, ATSPEngine engine) {
+    std::vector<std::size_t> tour;
+    return solveExtension(k, multiGraph, approx, threads, timeLimit, seed, engine, tour);
 }
 
-void splitRepeatedVertices(std::vector<std::vector<std::size_t>>& inputGraph, std::set<std::size_t>& X_in,
-                           std::set<std::size_t>& X_out, std::set<std::size_t>& Y,
-                           std::vector<std::vector<std::size_t>>& extensionMatrix) {
-    std::size_t verticesNumber = inputGraph.size();
-    std::set<std::size_t> verticesToSplit;
-    for (std::size_t v : X_in) {
-        if (X_out.find(v) != X_out.end()) {
-            verticesToSplit.insert(v);
-        }
+std::vector<std::vector<std::vector<std::size_t>>>
+findKHamiltonianExtensions(std::size_t kFirst, std::size_t kLast, const core::Multigraph& multiGraph, bool approx,
+                           unsigned int threads, std::chrono::steady_clock::duration timeLimit, std::uint64_t seed,
+                           ATSPEngine engine) {
+    if (kFirst > kLast) {
+        throw std::invalid_argument("Empty range of k");
     }
-
-    for (std::size_t oldVertex : verticesToSplit) {
-        std::size_t newVertex = inputGraph.size();
-        inputGraph.emplace_back(std::vector<std::size_t>(inputGraph.size() + 1, 0));
-        for (auto& row : inputGraph) {
-            row.push_back(0);
+    const std::size_t count = kLast - kFirst + 1;
+    const unsigned int available = core::resolveThreadCount(threads);
+    const unsigned int workers = static_cast<unsigned int>(std::min<std::size_t>(available, count));
+    const unsigned int solverThreads = std::max(1U, available / workers);
+
+    std::vector<std::vector<std::vector<std::size_t>>> extensions(count);
+    core::parallelFor(workers, workers, [&](std::size_t worker) {
+        // worker w takes the w-th of `workers` consecutive runs of k
+        std::vector<std::size_t> tour;
+        for (std::size_t i = worker * count / workers; i < (worker + 1) * count / workers; ++i) {
+            extensions[i] =
+                solveExtension(kFirst + i, multiGraph, approx, solverThreads, timeLimit, seed, engine, tour);
         }
+    });
+    return extensions;
+}
 
-        extensionMatrix.emplace_back(std::vector<std::size_t>(inputGraph.size() + 1, 0));
-        for (auto& row : extensionMatrix) {
-            row.push_back(0);
-        }
+// Role of a vertex in the path cover network, given by the extension arcs at it
+enum class VertexRole : unsigned char { Untouched, Start, End, Both };
 
-        for (std::size_t i = 0; i < verticesNumber; ++i) {
-            if (inputGraph[oldVertex][i] > 0) {
-                inputGraph[newVertex][i] = inputGraph[oldVertex][i];
-                inputGraph[oldVertex][i] = 0;
+static std::vector<VertexRole> classifyVertices(const std::vector<std::vector<std::size_t>>& extensionMatrix) {
+    const std::size_t n = extensionMatrix.size();
+    std::vector<unsigned char> touched(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            if (extensionMatrix[i][j] != 0) {
+                touched[i] |= 1;
+                touched[j] |= 2;
             }
         }
+    }
 
-        X_out.erase(oldVertex);
-        X_out.insert(newVertex);
+    std::vector<VertexRole> roles(n);
+    for (std::size_t v = 0; v < n; ++v) {
+        roles[v] = touched[v] == 0   ? VertexRole::Untouched
+                   : touched[v] == 1 ? VertexRole::Start
+                   : touched[v] == 2 ? VertexRole::End
+                                     : VertexRole::Both;
     }
+    return roles;
 }
 
-std::size_t findAllHamiltonianCycles(std::vector<std::vector<std::size_t>>& inputGraph,
-                                     std::vector<std::vector<std::size_t>>& extensionMatrix, std::size_t k) {
-    std::vector<std::vector<std::size_t>> cycles;
-
-    std::set<std::size_t> X_in, X_out, Y;
-    divideVertices(inputGraph, X_in, X_out, Y, extensionMatrix);
-    splitRepeatedVertices(inputGraph, X_in, X_out, Y, extensionMatrix);
-
-    std::size_t n = inputGraph.size();
-    hamilton::FlowGraph flowGraph(n + 2);
-    std::size_t source = n;
-    std::size_t sink = n + 1;
-
-    for (size_t x_i : X_in) {
-        flowGraph.addEdge(source, x_i, INF);
+// Paths from the ends of extension arcs (X_in) through untouched vertices (Y) to the starts of extension arcs (X_out):
+// the source feeds every X_in vertex, every X_out vertex feeds the sink and each arc of the graph leaving X_in or Y
+// and entering Y, or leaving Y and entering X_out, has capacity 1. A vertex that both ends and starts extension arcs
+// is split in two, one copy keeping its in-arcs and the other its out-arcs; as the copies sit in X_in and X_out,
+// neither has an arc of the network, so they are left out altogether.
+//
+// `forEachArc(v, f)` calls f(w) for the arcs v -> w of the graph, at least those entering Y or X_out. The edges are
+// counted before the network is allocated, so it is built in flat arrays of the final size.
+template <typename ForEachArc>
+static std::size_t maxPathFlow(const std::vector<VertexRole>& roles, ForEachArc&& forEachArc,
+                               FlowAlgorithm algorithm) {
+    const std::size_t n = roles.size();
+    const std::size_t source = n;
+    const std::size_t sink = n + 1;
+    auto carries = [&](std::size_t from, std::size_t to) {
+        return roles[to] == VertexRole::Untouched ||
+               (roles[to] == VertexRole::Start && roles[from] == VertexRole::Untouched);
+    };
+    auto leaves = [&](std::size_t v) {
+        return roles[v] == VertexRole::Untouched || roles[v] == VertexRole::End;
+    };
+
+    std::size_t edgeCount = 0;
+    for (std::size_t v = 0; v < n; ++v) {
+        if (roles[v] == VertexRole::End || roles[v] == VertexRole::Start) ++edgeCount;
+        if (!leaves(v)) continue;
+        forEachArc(v, [&](std::size_t w) {
+            if (carries(v, w)) ++edgeCount;
+        });
     }
 
-    for (size_t x_o : X_out) {
-        flowGraph.addEdge(x_o, sink, INF);
+    FlowGraph flowGraph(n + 2, edgeCount);
+    for (std::size_t v = 0; v < n; ++v) {
+        if (roles[v] == VertexRole::End) flowGraph.addEdge(source, v, INF);
+        if (roles[v] == VertexRole::Start) flowGraph.addEdge(v, sink, INF);
+        if (!leaves(v)) continue;
+        forEachArc(v, [&](std::size_t w) {
+            if (carries(v, w)) flowGraph.addEdge(v, w, 1);
+        });
     }
 
-    for (size_t x : X_out) {
-        for (size_t y : Y) {
-            if (inputGraph[y][x] > 0) {
-                flowGraph.addEdge(y, x, 1);
-            }
-        }
-    }
+    return flowGraph.maxFlow(source, sink, algorithm);
+}
 
-    for (size_t x : X_in) {
-        for (size_t y : Y) {
-            if (inputGraph[x][y] > 0) {
-                flowGraph.addEdge(x, y, 1);
+std::size_t findAllHamiltonianCycles(const std::vector<std::vector<std::size_t>>& inputGraph,
+                                     const std::vector<std::vector<std::size_t>>& extensionMatrix, std::size_t k,
+                                     FlowAlgorithm algorithm) {
+    return maxPathFlow(
+        classifyVertices(extensionMatrix),
+        [&](std::size_t v, auto&& f) {
+            for (std::size_t w = 0; w < inputGraph.size(); ++w) {
+                if (inputGraph[v][w] > 0) f(w);
             }
-        }
-    }
+        },
+        algorithm);
+}
 
-    for (size_t y_out : Y) {
-        for (size_t y_in : Y) {
-            if (inputGraph[y_out][y_in] > 0) {
-                flowGraph.addEdge(y_out, y_in, 1);
-            }
+std::size_t findAllHamiltonianCycles(const core::KThresholdBitGraph& kGraph,
+                                     const std::vector<std::vector<std::size_t>>& extensionMatrix,
+                                     FlowAlgorithm algorithm) {
+    // same network as the matrix variant, but only the k-graph row bits of Y and X_out vertices are visited
+    const auto roles = classifyVertices(extensionMatrix);
+    const std::size_t n = kGraph.vertexCount();
+    const std::size_t words = kGraph.wordsPerRow();
+    std::vector<core::word> entered(words, 0);
+    for (std::size_t v = 0; v < n; ++v) {
+        if (roles[v] == VertexRole::Untouched || roles[v] == VertexRole::Start) {
+            entered[v / core::WORD_BITS] |= core::word(1) << (v % core::WORD_BITS);
         }
     }
 
-    std::size_t maxFlow = flowGraph.edmondsKarp(source, sink);
-
-    return maxFlow;
+    std::vector<core::word> targets(words);
+    return maxPathFlow(
+        roles,
+        [&](std::size_t v, auto&& f) {
+            auto row = kGraph.row(v);
+            for (std::size_t w = 0; w < words; ++w) {
+                targets[w] = row[w] & entered[w];
+            }
+            for (auto w : core::BitNeighbourRange(targets.data(), words)) {
+                f(w);
+            }
+        },
+        algorithm);
 }
-} // namespace hamilton
+} // namespace hamilton
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef ATSP_BRANCH_AND_BOUND_HPP
+#define ATSP_BRANCH_AND_BOUND_HPP
+
+#include "assignment.hpp"
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace hamilton
+{
+// open search nodes per worker a parallel solve cuts the tree into, their subtrees vary a lot in size
+constexpr std::size_t ATSP_BRANCH_AND_BOUND_TASKS_PER_THREAD = 16;
+
+// Exact ATSP by depth-first branch and bound (Carpaneto and Toth). The assignment problem over the arcs a search node
+// allows bounds its tours from below. While the optimal assignment splits into several subtours, the node branches on
+// the one with the fewest free arcs a_1..a_r: the h-th child excludes a_h and includes a_1..a_h-1, so the children
+// partition the tours of the node and each one breaks that subtour. Patching the subtours of every assignment into
+// one tour supplies incumbents. Only the constraints along the current search path are kept, in an undo log over a
+// single cost matrix, so memory stays O(n^2). A parallel solve expands the tree breadth first until it has enough
+// open nodes, then workers with their own copy of the matrix claim the subtrees below them while sharing the cost of
+// the best tour found.
+class ATSPBranchAndBound {
+  public:
+    using Matrix = std::vector<std::vector<std::size_t>>;
+
+    // entries equal to std::numeric_limits<std::size_t>::max() are missing arcs, `tour` is the vertex order of a
+    // known tour used as the first incumbent, or empty
+    ATSPBranchAndBound(const Matrix& cost_matrix, const std::vector<std::size_t>& tour = {});
+
+    // vertex order of a cheapest tour, starting at vertex 0, searched by `threads` workers (0 meaning one per hardware
+    // thread)
+    std::vector<std::size_t> solve(unsigned int threads = 1);
+    // search nodes whose assignment problem was solved by the last solve
+    std::size_t nodes() const;
+
+  private:
+    struct Child {
+        std::size_t branch;
+        std::size_t bound;
+        std::vector<std::size_t> successor;
+    };
+    using Arcs = std::vector<std::pair<std::size_t, std::size_t>>;
+    // open node of a parallel solve: the branches taken from the root, and the assignment solved under them
+    struct Task {
+        std::vector<std::pair<Arcs, std::size_t>> branches;
+        std::size_t bound;
+        std::vector<std::size_t> successor;
+    };
+
+    std::size_t n_;
+    // cost standing for a missing, excluded or blocked arc, more than any tour costs
+    std::size_t forbidden_;
+    // row-major arc costs of the instance, and under the constraints of the current search node
+    std::vector<std::size_t> base_costs_;
+    std::vector<std::size_t> costs_;
+    // entries of costs_ overwritten by the constraints on the search path, with their previous values; an index past
+    // n^2 records that the arc leaving vertex index - n^2 was included
+    std::vector<std::pair<std::size_t, std::size_t>> undo_log_;
+    // whether the arc leaving every vertex is fixed by the constraints on the search path
+    std::vector<bool> included_;
+    std::vector<std::size_t> best_successor_;
+    std::size_t best_cost_;
+    std::size_t nodes_ = 0;
+    metric::AssignmentSolver assignment_solver_;
+    // cost of the best tour over all workers of a parallel solve, null when solving on one thread
+    std::atomic<std::size_t>* shared_best_cost_ = nullptr;
+
+    // optimal assignment under the current constraints as a successor per vertex, returns its cost, forbidden_ or
+    // more when the constraints leave no assignment
+    std::size_t assign(std::vector<std::size_t>& successor);
+    void exclude(std::size_t from, std::size_t to);
+    void include(std::size_t from, std::size_t to);
+    // the first `branch` free arcs are included and the next one is excluded
+    void constrain(const Arcs& arcs, std::size_t branch);
+    void rollback(std::size_t checkpoint);
+    // cost of the tour given by a successor per vertex, or forbidden_ when it uses a missing arc
+    std::size_t tour_cost(const std::vector<std::size_t>& successor) const;
+    // the best tour cost known to this search, found by any worker
+    std::size_t best_cost() const;
+    void offer(const std::vector<std::size_t>& successor);
+    // merges the cycles of an assignment into one tour by the cheapest exchange of two arcs at a time
+    void patch(std::vector<std::size_t> successor, const std::vector<std::vector<std::size_t>>& cycles);
+    // Offers the assignment when it is a tour and its patched tour otherwise. Returns the free arcs of the subtour to
+    // branch on, empty when the node has no children.
+    Arcs branch_arcs(const std::vector<std::size_t>& successor);
+    // children of the current node branching on `arcs` bounded below the best tour, cheapest bound first
+    std::vector<Child> children(const Arcs& arcs);
+    void search(const std::vector<std::size_t>& successor);
+    void search_parallel(const std::vector<std::size_t>& successor, std::size_t bound, unsigned int threads);
+};
+
+} // namespace hamilton
+
+#endif // ATSP_BRANCH_AND_BOUND_HPP
@@ -0,0 +1,82 @@
+#ifndef ATSP_LOCAL_SEARCH_HPP
+#define ATSP_LOCAL_SEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace hamilton
+{
+// candidate successors and predecessors kept per vertex
+constexpr std::size_t ATSP_NEIGHBOUR_LIST_SIZE = 10;
+
+// Local search for ATSP tours with moves that keep the direction of every arc, so no move pays for reversing a
+// segment. Both neighbourhoods are special cases of the reversal-free 3-opt move, which cuts the arcs leaving x, y
+// and z (in tour order) and swaps the two segments between them:
+//  - or-3opt: the new arcs x -> succ(y) and y -> succ(z) are drawn from the cheapest successors of x and y, with
+//    the partial gain kept positive after each of them;
+//  - Or-opt: a segment of up to three vertices is reinserted between a cheap predecessor of its first vertex or a
+//    cheap successor of its last vertex and the vertex following it.
+// Vertices are examined from a queue of don't-look bits: a vertex without an improving move is dropped until a move
+// changes one of its arcs. The tour is an array with the position of every vertex; a move rewrites the two shortest
+// of the three segments it involves.
+class ATSPLocalSearch {
+  public:
+    using Matrix = std::vector<std::vector<std::size_t>>;
+
+    // entries equal to std::numeric_limits<std::size_t>::max() are missing arcs, priced above any tour without them
+    ATSPLocalSearch(const Matrix& cost_matrix, std::size_t neighbours = ATSP_NEIGHBOUR_LIST_SIZE);
+
+    // improves a tour, given as a vertex order, until no move gains
+    void improve(std::vector<std::size_t>& tour);
+    // the same, but only the given vertices start out queued, for a tour that is locally optimal elsewhere
+    void improve(std::vector<std::size_t>& tour, const std::vector<std::size_t>& active);
+    // total cost of a tour, missing arcs counted at their penalty
+    std::int64_t tour_cost(const std::vector<std::size_t>& tour) const;
+
+  private:
+    const Matrix& cost_matrix_;
+    std::size_t n_;
+    std::int64_t penalty_;
+    std::size_t neighbours_;
+    // row-major lists of the `neighbours_` cheapest successors and predecessors of every vertex, cheapest first
+    std::vector<std::size_t> successors_;
+    std::vector<std::size_t> predecessors_;
+
+    std::vector<std::size_t> tour_;
+    std::vector<std::size_t> position_;
+    std::deque<std::size_t> queue_;
+    std::vector<bool> queued_;
+    std::vector<std::size_t> buffer_;
+
+    std::int64_t cost(std::size_t from, std::size_t to) const {
+        const std::size_t arc = cost_matrix_[from][to];
+        return arc == std::numeric_limits<std::size_t>::max() ? penalty_ : static_cast<std::int64_t>(arc);
+    }
+    std::size_t succ(std::size_t v) const {
+        return tour_[position_[v] + 1 == n_ ? 0 : position_[v] + 1];
+    }
+    std::size_t pred(std::size_t v) const {
+        return tour_[position_[v] == 0 ? n_ - 1 : position_[v] - 1];
+    }
+    // steps from `from` to `to` along the tour
+    std::size_t offset(std::size_t from, std::size_t to) const {
+        return position_[to] >= position_[from] ? position_[to] - position_[from]
+                                                : position_[to] + n_ - position_[from];
+    }
+
+    void activate(std::size_t v);
+    // replaces the arcs leaving x, y and z, which follow each other in this order, by x -> succ(y), z -> succ(x) and
+    // y -> succ(z)
+    void move(std::size_t x, std::size_t y, std::size_t z);
+    // swaps the adjacent segments of `first` and `second` vertices starting at position `start`
+    void swap_segments(std::size_t start, std::size_t first, std::size_t second);
+    bool improve_or3opt(std::size_t x);
+    bool improve_or_opt(std::size_t first);
+};
+
+} // namespace hamilton
+
+#endif // ATSP_LOCAL_SEARCH_HPP
@@ -0,0 +1,55 @@
+#ifndef ATSP_REDUCTION_HPP
+#define ATSP_REDUCTION_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace hamilton
+{
+
+// Shrinks an ATSP instance by contracting arcs that some optimal tour is known to use. The contracted vertices form
+// chains, and a chain acts as a single vertex whose arcs leave its last vertex and enter its first one, so every
+// tour of the reduced instance extends to a tour of the original one at the same cost plus the chain arcs.
+//
+// An arc u -> v of the cheapest cost of the instance is contracted when either
+//  - every arc u -> a costs at least as much as any other arc into a, and every arc b -> u at most as much as b -> v,
+//  - or every arc b -> v costs at least as much as any other arc out of b, and every arc v -> a at most as much as
+//    u -> a.
+// Given a tour u -> a ... b -> v ... w -> u avoiding the arc, the first condition makes u -> v ... w -> a ... b -> u
+// no more expensive, the second u -> v -> a ... b -> z ... u, where z followed v. Taking arcs away from the instance
+// keeps both conditions true, so the checks are repeated on the contracted instance until no arc passes them. On
+// k-extension costs with k = 1 they hold for a k-arc that is the only one leaving u and the only one entering v.
+class ATSPReduction {
+  public:
+    using Matrix = std::vector<std::vector<std::size_t>>;
+
+    ATSPReduction(const Matrix& cost_matrix);
+
+    // cost matrix over the chains, the diagonal holds the arc closing each chain into a cycle
+    const Matrix& reduced() const;
+    // turns a tour matrix over the chains, with the cost of every tour arc as ATSPSolver returns it, into one over
+    // the original vertices holding the costs of the chain arcs as well
+    Matrix expand(const Matrix& reduced_cycle) const;
+    // order of the chains along a tour of the original instance, given as a vertex order, by their first vertices
+    std::vector<std::size_t> reduce_tour(const std::vector<std::size_t>& tour) const;
+
+  private:
+    const Matrix& cost_matrix_;
+    std::size_t n_;
+    // successor of every vertex inside its chain, n_ at the end of a chain
+    std::vector<std::size_t> next_;
+    // first and last vertex of every chain
+    std::vector<std::size_t> heads_;
+    std::vector<std::size_t> tails_;
+    Matrix reduced_;
+
+    std::size_t cost(std::size_t from, std::size_t to) const {
+        return cost_matrix_[tails_[from]][heads_[to]];
+    }
+    // contracts every arc between chains that passes the checks against the current chains, returns whether any did
+    bool contract();
+};
+
+} // namespace hamilton
+
+#endif // ATSP_REDUCTION_HPP
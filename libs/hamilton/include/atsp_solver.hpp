@@ -2,28 +2,81 @@
 #define ATSP_HPP
 
 #include <vector>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <algorithm>
 #include <limits>
 #include <stdexcept>
 
 namespace hamilton
 {
+// masks of one Held-Karp layer handed to a worker at a time
+constexpr std::size_t HELD_KARP_RUN_LENGTH = 1024;
+constexpr std::size_t HELD_KARP_ALWAYS_VERTICES = 12;
+constexpr std::size_t HELD_KARP_SPARSE_VERTICES = 16;
+// unvisited vertices among which a randomized nearest neighbour construction picks the next one
+constexpr std::size_t ATSP_RANDOMIZED_CHOICES = 3;
+// kicks in a row without improvement after which a multi-start worker starts over from a new construction
+constexpr std::size_t ATSP_RESTART_STALL = 100;
+
+// Exact engine of ATSPSolver::solve. Auto picks one per instance, see ATSPSolver::prefers_held_karp.
+enum class ATSPEngine { Auto, HeldKarp, BranchAndBound };
 
 // Asymmetric Traveling Salesman Problem solver using Held-Karp algorithm (dynamic programming)
 class ATSPSolver {
   public:
     using Matrix = std::vector<std::vector<std::size_t>>;
+    // set of the vertices 1..n-1 visited by a path from vertex 0, vertex v on bit v - 1
+    using Mask = std::uint64_t;
 
-    ATSPSolver(const Matrix& cost_matrix);
-    Matrix solve();
+    // entries equal to std::numeric_limits<std::size_t>::max() are missing arcs
+    ATSPSolver(Matrix cost_matrix);
+    // Exact tour by the given engine on `threads` workers (0 meaning one per hardware thread). Held-Karp takes
+    // seconds from about 24 vertices on, but its time does not depend on the costs; the branch and bound usually goes
+    // much further, though without a bound on its time.
+    Matrix solve(unsigned int threads = 1, ATSPEngine engine = ATSPEngine::Auto);
+    // Exact tour in O(2^n n^2) time. The table holds one cost per subset of the vertices 1..n-1 and end vertex in a
+    // single contiguous buffer of the narrowest unsigned type that fits every tour cost, and the tour is
+    // reconstructed from the costs alone, so vertex 0 and a parent table take no memory. The subsets of one size are
+    // independent and split between `threads` workers.
+    Matrix solve_held_karp(unsigned int threads = 1);
+    // Exact tour by branch and bound over assignment problem bounds (ATSPBranchAndBound) in O(n^2) memory per worker,
+    // starting from the approximate() tour. Exponential in the worst case, but fast when the cheapest arcs nearly
+    // form a tour.
+    Matrix solve_branch_and_bound(unsigned int threads = 1);
     Matrix approximate();
+    // Vertex order of a known tour, such as one for a similar instance. The branch and bound and both approximations
+    // improve it by local search and start from it when it beats their nearest neighbour tour.
+    void warm_start(std::vector<std::size_t> tour);
+    // Multi-start iterated local search on `threads` workers (0 meaning one per hardware thread) sharing the best
+    // tour found. Each worker builds a tour by randomized nearest neighbour from a random vertex, improves it with
+    // ATSPLocalSearch, then repeatedly applies a double-bridge kick and local search, keeping the result unless it
+    // is worse, and starts over after ATSP_RESTART_STALL kicks in a row without improvement. The first worker
+    // starts from the approximate() tour, so the result is never worse. Workers stop at the time limit or when
+    // `iteration_limit` kicks and starts have been spent, zero meaning no limit; at least one of them must be set.
+    // Worker w draws from a stream seeded by `seed` and w and ties go to the lower worker, so an iteration limit
+    // without a time limit makes runs with the same seed and thread count reproducible.
+    Matrix approximate(unsigned int threads, std::chrono::steady_clock::duration time_limit, std::uint64_t seed,
+                       std::size_t iteration_limit = 0);
 
   private:
     Matrix cost_matrix_;
     std::size_t n_;
+    std::vector<std::size_t> warm_start_;
 
     Matrix reconstruct_cycle(const std::vector<std::size_t>& path);
+    // vertex order of the nearest neighbour tour from vertex 0 improved by ATSPLocalSearch, or of the improved warm
+    // start tour when that is cheaper
+    std::vector<std::size_t> approximate_tour() const;
+    // Held-Karp up to HELD_KARP_ALWAYS_VERTICES vertices, where it takes well under a millisecond, and up to
+    // HELD_KARP_SPARSE_VERTICES when fewer than two arcs per vertex cost the minimum of their row. With few cheapest
+    // arcs the assignment bound tends to be loose and the branch and bound tree large, while Held-Karp stays within
+    // milliseconds; beyond that branch and bound is faster on all but adversarial instances.
+    bool prefers_held_karp() const;
+    // longest finite arc cost, every tour costs at most n times this
+    std::size_t max_arc_cost() const;
+    template <typename Cost> std::vector<std::size_t> held_karp(unsigned int threads) const;
 };
 
 } // namespace hamilton
@@ -3,7 +3,6 @@
 
 #include <vector>
 #include <cstddef>
-#include <queue>
 #include <limits>
 
 namespace hamilton
@@ -11,19 +10,51 @@ namespace hamilton
 
 const std::size_t INF = std::numeric_limits<std::size_t>::max();
 
+enum class FlowAlgorithm { Dinic, PushRelabel };
+
+// Residual network on adjacency lists. addEdge stores an edge next to its reverse edge, so edge e and e ^ 1 always
+// form a pair, and the edges leaving a vertex are chained through flat arrays indexed by edge. Residual capacities
+// are updated in place: pushing f units along e subtracts f from e and adds it to e ^ 1, so no flow ever goes
+// negative. Each max-flow call continues from the flow left by the previous one.
 class FlowGraph {
   public:
-    std::vector<std::vector<std::size_t>> capacity;
-    std::vector<std::vector<std::size_t>> flow;
     std::size_t vertexCount;
 
-    FlowGraph(std::size_t n);
+    // `edgeCount` edges are allocated up front
+    FlowGraph(std::size_t n, std::size_t edgeCount = 0);
 
+    void reserveEdges(std::size_t edgeCount);
     void addEdge(std::size_t u, std::size_t v, std::size_t cap);
 
-    bool bfs(std::size_t source, std::size_t sink, std::vector<std::size_t>& parent);
-
-    std::size_t edmondsKarp(std::size_t source, std::size_t sink);
+    std::size_t maxFlow(std::size_t source, std::size_t sink, FlowAlgorithm algorithm = FlowAlgorithm::Dinic);
+    // blocking flows along BFS levels, O(V^2 E), O(E sqrt(V)) on unit capacity networks
+    std::size_t dinic(std::size_t source, std::size_t sink);
+    // FIFO push-relabel with the gap heuristic, O(V^3). The capacities of the edges that do not leave the source have
+    // to sum up to less than INF, the source's own edges may be INF.
+    std::size_t pushRelabel(std::size_t source, std::size_t sink);
+
+  private:
+    static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+    // first edge leaving every vertex, and per edge its head, residual capacity and the next edge of its tail
+    std::vector<std::size_t> head_;
+    std::vector<std::size_t> to_;
+    std::vector<std::size_t> residual_;
+    std::vector<std::size_t> next_;
+
+    std::vector<std::size_t> level_;
+    std::vector<std::size_t> current_;
+    std::vector<std::size_t> path_;
+
+    std::size_t tail(std::size_t edge) const {
+        return to_[edge ^ 1];
+    }
+    void push(std::size_t edge, std::size_t amount) {
+        residual_[edge] -= amount;
+        residual_[edge ^ 1] += amount;
+    }
+    bool bfs(std::size_t source, std::size_t sink);
+    std::size_t blockingFlow(std::size_t source, std::size_t sink);
 };
 
 } // namespace hamilton
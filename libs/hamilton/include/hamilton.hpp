@@ -2,21 +2,44 @@
 #define HAMILTON_HPP
 
 #include <vector>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <algorithm>
 #include <iostream>
 #include "core.hpp"
+#include "bit_graph.hpp"
+#include "atsp_solver.hpp"
+#include "flowGraph.hpp"
 
 namespace hamilton
 {
-std::vector<std::vector<std::size_t>> findKHamiltonianExtension(std::size_t k, core::Multigraph multiGraph,
-                                                                bool approx);
+// The exact solver runs `engine` on `threads` workers, 0 meaning one per hardware thread. With a time limit the
+// approximation runs the multi-start search on the workers for that long, seeded by `seed`.
+std::vector<std::vector<std::size_t>>
+findKHamiltonianExtension(std::size_t k, const core::Multigraph& multiGraph, bool approx, unsigned int threads = 1,
+                          std::chrono::steady_clock::duration timeLimit = std::chrono::steady_clock::duration::zero(),
+                          std::uint64_t seed = 0, ATSPEngine engine = ATSPEngine::Auto);
 
-void divideVertices(std::vector<std::vector<std::size_t>>& inputGraph, std::vector<std::size_t>& X,
-                    std::vector<std::size_t>& Y, std::vector<std::vector<std::size_t>>& extensionMatrix);
+// Extensions for every k from kFirst to kLast, in that order. The range is cut into consecutive runs of k solved in
+// parallel by the `threads` workers, each sharing the rest of the threads between the solvers of its run. Within a run
+// every ATSP starts from the tour found for the previous k, which stays cheap as the costs only grow with k.
+std::vector<std::vector<std::vector<std::size_t>>>
+findKHamiltonianExtensions(std::size_t kFirst, std::size_t kLast, const core::Multigraph& multiGraph, bool approx,
+                           unsigned int threads = 1,
+                           std::chrono::steady_clock::duration timeLimit = std::chrono::steady_clock::duration::zero(),
+                           std::uint64_t seed = 0, ATSPEngine engine = ATSPEngine::Auto);
 
-std::size_t findAllHamiltonianCycles(std::vector<std::vector<std::size_t>>& inputGraph,
-                                     std::vector<std::vector<std::size_t>>& extensionMatrix, std::size_t k);
+// Counts the vertex-disjoint paths the graph offers from the ends of the extension arcs, through vertices the
+// extension leaves untouched, to the starts of extension arcs, by a maximum flow computed with `algorithm`.
+std::size_t findAllHamiltonianCycles(const std::vector<std::vector<std::size_t>>& inputGraph,
+                                     const std::vector<std::vector<std::size_t>>& extensionMatrix, std::size_t k,
+                                     FlowAlgorithm algorithm = FlowAlgorithm::Dinic);
+
+// the same on the arcs of multiplicity at least k, the threshold `kGraph` was built with
+std::size_t findAllHamiltonianCycles(const core::KThresholdBitGraph& kGraph,
+                                     const std::vector<std::vector<std::size_t>>& extensionMatrix,
+                                     FlowAlgorithm algorithm = FlowAlgorithm::Dinic);
 } // namespace hamilton
 
 #endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "anytime_metric.hpp"
+#include "assignment_metric.hpp"
+#include "branch_and_bound.hpp"
+#include "graph_signature.hpp"
+#include "mapping_cost.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace metric
+{
+
+using Clock = std::chrono::steady_clock;
+
+AnytimeMetric::AnytimeMetric(Clock::duration timeLimit, std::size_t iterationLimit)
+    : _timeLimit(timeLimit), _iterationLimit(iterationLimit) {
+    if (timeLimit <= Clock::duration::zero() && iterationLimit == 0) {
+        throw std::invalid_argument("Anytime metric needs a time or an iteration limit");
+    }
+}
+
+// improveBySwaps that keeps track of the cost and gives up at the deadline
+static std::size_t descend(const PaddedPair& graphs, std::vector<vertex>& assignment, std::size_t cost,
+                           Clock::time_point deadline) {
+    for (bool improved = true; improved;) {
+        improved = false;
+        for (vertex a = 0; a < graphs.n; a++) {
+            if (Clock::now() >= deadline) return cost;
+            for (vertex b = a + 1; b < graphs.n; b++) {
+                auto delta = swapDelta(graphs, assignment, a, b);
+                if (delta >= 0) continue;
+                std::swap(assignment[a], assignment[b]);
+                cost -= static_cast<std::size_t>(-delta);
+                improved = true;
+            }
+        }
+    }
+    return cost;
+}
+
+DistanceBounds AnytimeMetric::bounds(const core::Multigraph& G, const core::Multigraph& H) const {
+    if (G.vertexCount() < H.vertexCount()) {
+        auto result = bounds(H, G);
+        auto inverse = std::vector<vertex>(G.vertexCount());
+        for (vertex x = 0; x < result.mapping.size(); x++) {
+            if (result.mapping[x] < G.vertexCount()) inverse[result.mapping[x]] = x;
+        }
+        result.mapping = std::move(inverse);
+        return result;
+    }
+
+    const auto deadline = _timeLimit > Clock::duration::zero() ? Clock::now() + _timeLimit : Clock::time_point::max();
+    const auto offset = G.vertexCount() - H.vertexCount();
+    const auto graphs = PaddedPair(G, H);
+    const auto n = graphs.n;
+
+    std::vector<vertex> mapping;
+    auto lower = signatureAssignment(graphs, mapping);
+    if (Clock::now() < deadline) {
+        lower = std::max(lower, GraphSignature::lowerBound(GraphSignature(G), GraphSignature(H)) - offset);
+    }
+    if (Clock::now() < deadline) refineAssignment(graphs, mapping);
+    auto cost = descend(graphs, mapping, mappingCost(graphs, mapping), deadline);
+
+    if (cost > lower && n <= ANYTIME_BRANCH_AND_BOUND_MAX_VERTICES && Clock::now() < deadline) {
+        BranchAndBound search(G, H);
+        search.seed(mapping);
+        auto found = search.solve(1, lower, deadline, _iterationLimit);
+        if (found < cost) {
+            cost = found;
+            mapping = search.mapping();
+        }
+        if (!search.expired()) lower = found;
+    } else if (cost > lower) {
+        // a fixed seed keeps the answer reproducible for the same budget
+        std::mt19937_64 random(n);
+        for (std::size_t iteration = 0; cost > lower && (_iterationLimit == 0 || iteration < _iterationLimit) &&
+                                         Clock::now() < deadline;
+             iteration++) {
+            auto candidate = mapping;
+            // a few random swaps leave the basin of a mapping no single swap improves
+            for (std::size_t kick = 0; kick < 3; kick++)
+                std::swap(candidate[random() % n], candidate[random() % n]);
+            auto candidateCost = descend(graphs, candidate, mappingCost(graphs, candidate), deadline);
+            // equal costs are accepted too, to drift along plateaus
+            if (candidateCost <= cost) {
+                cost = candidateCost;
+                mapping = std::move(candidate);
+            }
+        }
+    }
+
+    return DistanceBounds{offset + lower, offset + cost, std::move(mapping), lower == cost};
+}
+
+std::size_t AnytimeMetric::operator()(const core::Multigraph& G, const core::Multigraph& H) const {
+    return bounds(G, H).upperBound;
+}
+
+std::size_t AnytimeMetric::lowerBound(const CachedGraph& G, const CachedGraph& H) const {
+    return GraphSignature::lowerBound(G.signature, H.signature);
+}
+
+} // namespace metric
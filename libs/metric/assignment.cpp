@@ -0,0 +1,73 @@
+#include "assignment.hpp"
+
+#include <limits>
+#include <vector>
+
+namespace metric
+{
+
+std::size_t AssignmentSolver::solve(std::span<const std::size_t> costs, std::size_t size) {
+    // rows and columns are 1-based below, index 0 is the virtual start of every augmenting path
+    const auto infinity = std::numeric_limits<std::int64_t>::max();
+    _rowPotential.assign(size + 1, 0);
+    _columnPotential.assign(size + 1, 0);
+    _columnMatch.assign(size + 1, 0);
+    _way.assign(size + 1, 0);
+
+    for (std::size_t row = 1; row <= size; row++) {
+        _columnMatch[0] = row;
+        std::size_t column = 0;
+        _minimum.assign(size + 1, infinity);
+        _visited.assign(size + 1, false);
+
+        do {
+            _visited[column] = true;
+            auto matchedRow = _columnMatch[column];
+            auto delta = infinity;
+            std::size_t nextColumn = 0;
+            for (std::size_t j = 1; j <= size; j++) {
+                if (_visited[j]) continue;
+                auto reduced = static_cast<std::int64_t>(costs[(matchedRow - 1) * size + j - 1]) -
+                               _rowPotential[matchedRow] - _columnPotential[j];
+                if (reduced < _minimum[j]) {
+                    _minimum[j] = reduced;
+                    _way[j] = column;
+                }
+                if (_minimum[j] < delta) {
+                    delta = _minimum[j];
+                    nextColumn = j;
+                }
+            }
+            for (std::size_t j = 0; j <= size; j++) {
+                if (_visited[j]) {
+                    _rowPotential[_columnMatch[j]] += delta;
+                    _columnPotential[j] -= delta;
+                } else {
+                    _minimum[j] -= delta;
+                }
+            }
+            column = nextColumn;
+        } while (_columnMatch[column] != 0);
+
+        // flip the augmenting path back to the start
+        do {
+            auto previous = _way[column];
+            _columnMatch[column] = _columnMatch[previous];
+            column = previous;
+        } while (column != 0);
+    }
+
+    _assignment.assign(size, 0);
+    std::size_t total = 0;
+    for (std::size_t j = 1; j <= size; j++) {
+        _assignment[_columnMatch[j] - 1] = j - 1;
+        total += costs[(_columnMatch[j] - 1) * size + j - 1];
+    }
+    return total;
+}
+
+const std::vector<std::size_t>& AssignmentSolver::assignment() const {
+    return _assignment;
+}
+
+} // namespace metric
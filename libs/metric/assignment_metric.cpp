@@ -0,0 +1,110 @@
+#include "assignment_metric.hpp"
+#include "assignment.hpp"
+#include "graph_signature.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace metric
+{
+
+inline static std::size_t absDiff(std::size_t a, std::size_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// n - 1 multiplicities of every row (transposed: column) without the loop, each sorted in increasing order
+static std::vector<std::size_t> sortedLines(const std::vector<std::size_t>& matrix, std::size_t n, bool transposed) {
+    auto lines = std::vector<std::size_t>(n * (n - 1));
+    for (vertex u = 0; u < n; u++) {
+        auto line = lines.data() + u * (n - 1);
+        std::size_t size = 0;
+        for (vertex v = 0; v < n; v++) {
+            if (v != u) line[size++] = transposed ? matrix[v * n + u] : matrix[u * n + v];
+        }
+        std::sort(line, line + size);
+    }
+    return lines;
+}
+
+std::size_t signatureAssignment(const PaddedPair& graphs, std::vector<vertex>& assignment) {
+    const auto n = graphs.n;
+    assignment.clear();
+    if (n == 0) return 0;
+
+    const auto rowsG = sortedLines(graphs.g, n, false);
+    const auto columnsG = sortedLines(graphs.g, n, true);
+    const auto rowsH = sortedLines(graphs.h, n, false);
+    const auto columnsH = sortedLines(graphs.h, n, true);
+
+    // Sorted sequences paired in order differ the least over all pairings of their entries. An arc between two
+    // vertices shows up in the row of one and the column of the other, the loop in neither, so it is counted twice.
+    auto costs = std::vector<std::size_t>(n * n);
+    for (vertex u = 0; u < n; u++) {
+        for (vertex w = 0; w < n; w++) {
+            costs[u * n + w] = 2 * absDiff(graphs.g[u * n + u], graphs.h[w * n + w]) +
+                               absDiffSum(&rowsG[u * (n - 1)], &rowsH[w * (n - 1)], n - 1) +
+                               absDiffSum(&columnsG[u * (n - 1)], &columnsH[w * (n - 1)], n - 1);
+        }
+    }
+
+    AssignmentSolver solver;
+    auto cost = solver.solve(costs, n);
+    assignment.assign(solver.assignment().begin(), solver.assignment().end());
+    return (cost + 1) / 2;
+}
+
+void refineAssignment(const PaddedPair& graphs, std::vector<vertex>& assignment) {
+    const auto n = graphs.n;
+    auto transposedG = std::vector<std::size_t>(n * n);
+    auto transposedH = std::vector<std::size_t>(n * n);
+    for (vertex u = 0; u < n; u++) {
+        for (vertex v = 0; v < n; v++) {
+            transposedG[v * n + u] = graphs.g[u * n + v];
+            transposedH[v * n + u] = graphs.h[u * n + v];
+        }
+    }
+
+    auto costs = std::vector<std::size_t>(n * n);
+    AssignmentSolver solver;
+    for (auto cost = mappingCost(graphs, assignment);;) {
+        for (vertex u = 0; u < n; u++) {
+            for (vertex w = 0; w < n; w++) {
+                costs[u * n + w] =
+                    absDiffSumGathered(&graphs.g[u * n], &graphs.h[w * n], assignment.data(), n) +
+                    absDiffSumGathered(&transposedG[u * n], &transposedH[w * n], assignment.data(), n);
+            }
+        }
+        solver.solve(costs, n);
+        auto refined = std::vector<vertex>(solver.assignment().begin(), solver.assignment().end());
+        auto refinedCost = mappingCost(graphs, refined);
+        if (refinedCost >= cost) return;
+        assignment = std::move(refined);
+        cost = refinedCost;
+    }
+}
+
+AssignmentMetric::AssignmentMetric(bool localSearch) : _localSearch(localSearch) {
+}
+
+std::vector<vertex> AssignmentMetric::mapping(const PaddedPair& graphs) const {
+    std::vector<vertex> assignment;
+    signatureAssignment(graphs, assignment);
+    refineAssignment(graphs, assignment);
+    if (_localSearch) improveBySwaps(graphs, assignment);
+    return assignment;
+}
+
+std::size_t AssignmentMetric::operator()(const core::Multigraph& G, const core::Multigraph& H) const {
+    if (G.vertexCount() < H.vertexCount()) return this->operator()(H, G);
+
+    const auto graphs = PaddedPair(G, H);
+    return G.vertexCount() - H.vertexCount() + mappingCost(graphs, mapping(graphs));
+}
+
+std::size_t AssignmentMetric::lowerBound(const CachedGraph& G, const CachedGraph& H) const {
+    return GraphSignature::lowerBound(G.signature, H.signature);
+}
+
+} // namespace metric
@@ -0,0 +1,335 @@
+#include "branch_and_bound.hpp"
+#include "assignment_metric.hpp"
+#include "kernels.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+namespace metric
+{
+
+inline static std::size_t absDiff(std::size_t a, std::size_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// copies a sorted slot without one occurrence of value
+inline static void copyWithout(const std::size_t* from, std::size_t* to, std::size_t size, std::size_t value) {
+    auto position = std::lower_bound(from, from + size, value) - from;
+    std::copy(from, from + position, to);
+    std::copy(from + position + 1, from + size, to + position);
+}
+
+BranchAndBound::BranchAndBound(const core::Multigraph& G, const core::Multigraph& H)
+    : _n(G.vertexCount()), _m(H.vertexCount()), _graphs(G, H),
+      _sortedRowsG(_n + 1, std::vector<std::size_t>(_n * _n)),
+      _sortedColumnsG(_n + 1, std::vector<std::size_t>(_n * _n)),
+      _sortedRowsH(_n + 1, std::vector<std::size_t>(_n * _n)),
+      _sortedColumnsH(_n + 1, std::vector<std::size_t>(_n * _n)), _costs(_n + 1, std::vector<std::size_t>(_n * _n)),
+      _assignment(_n), _used(_n), _candidates(_n) {
+    std::vector<std::size_t> degreesG(_n, 0);
+    for (vertex u = 0; u < _n; u++) {
+        for (vertex v = 0; v < _n; v++) {
+            if (u == v) continue;
+            degreesG[u] += _graphs.g[u * _n + v];
+            degreesG[v] += _graphs.g[u * _n + v];
+        }
+    }
+
+    // vertices with many edges constrain the mapping the most, so they are assigned first
+    _order = std::vector<vertex>(_n);
+    std::iota(_order.begin(), _order.end(), 0);
+    std::stable_sort(_order.begin(), _order.end(), [&](vertex a, vertex b) { return degreesG[a] > degreesG[b]; });
+
+    // the unassigned G vertices of every depth are known up front
+    for (std::size_t depth = 0; depth < _n; depth++) {
+        for (auto i = depth; i < _n; i++) {
+            auto u = _order[i];
+            auto row = _sortedRowsG[depth].data() + u * _n;
+            auto column = _sortedColumnsG[depth].data() + u * _n;
+            std::size_t size = 0;
+            for (auto j = depth; j < _n; j++) {
+                auto v = _order[j];
+                if (v == u) continue;
+                row[size] = _graphs.g[u * _n + v];
+                column[size++] = _graphs.g[v * _n + u];
+            }
+            std::sort(row, row + size);
+            std::sort(column, column + size);
+        }
+    }
+
+    for (vertex w = 0; w < _n; w++) {
+        auto row = _sortedRowsH[0].data() + w * _n;
+        auto column = _sortedColumnsH[0].data() + w * _n;
+        std::size_t size = 0;
+        for (vertex x = 0; x < _n; x++) {
+            if (x == w) continue;
+            row[size] = _graphs.h[w * _n + x];
+            column[size++] = _graphs.h[x * _n + w];
+        }
+        std::sort(row, row + size);
+        std::sort(column, column + size);
+    }
+
+    for (vertex u = 0; u < _n; u++) {
+        for (vertex w = 0; w < _n; w++) {
+            _costs[0][u * _n + w] = absDiff(_graphs.g[u * _n + u], _graphs.h[w * _n + w]);
+        }
+    }
+}
+
+std::vector<vertex> BranchAndBound::heuristicMapping() const {
+    return AssignmentMetric().mapping(_graphs);
+}
+
+std::size_t BranchAndBound::upperBound() const {
+    return mappingCost(_graphs, heuristicMapping());
+}
+
+void BranchAndBound::assign(std::size_t depth, vertex u, vertex w) {
+    // u -> w fixes the arcs between u and every vertex assigned later, charge them to that vertex's costs
+    const auto& costs = _costs[depth];
+    auto& nextCosts = _costs[depth + 1];
+    const auto size = _n - depth - 1;
+    for (vertex x = 0; x < _n; x++) {
+        if (_used[x]) continue;
+        copyWithout(_sortedRowsH[depth].data() + x * _n, _sortedRowsH[depth + 1].data() + x * _n, size,
+                    _graphs.h[x * _n + w]);
+        copyWithout(_sortedColumnsH[depth].data() + x * _n, _sortedColumnsH[depth + 1].data() + x * _n, size,
+                    _graphs.h[w * _n + x]);
+    }
+    for (auto i = depth + 1; i < _n; i++) {
+        auto v = _order[i];
+        for (vertex x = 0; x < _n; x++) {
+            if (_used[x]) continue;
+            nextCosts[v * _n + x] = costs[v * _n + x] + absDiff(_graphs.g[v * _n + u], _graphs.h[x * _n + w]) +
+                                    absDiff(_graphs.g[u * _n + v], _graphs.h[w * _n + x]);
+        }
+    }
+}
+
+std::size_t BranchAndBound::lowerBound(std::size_t depth, std::size_t budget) {
+    // Every arc between two unassigned vertices is charged once through the row of its tail and once through the
+    // column of its head, so the costs are doubled and the resulting bound halved.
+    const auto& costs = _costs[depth];
+    const auto& rowsG = _sortedRowsG[depth];
+    const auto& columnsG = _sortedColumnsG[depth];
+    const auto& rowsH = _sortedRowsH[depth];
+    const auto& columnsH = _sortedColumnsH[depth];
+    const auto size = _n - depth;
+    const auto none = std::numeric_limits<std::size_t>::max();
+
+    _boundCosts.resize(size * size);
+    _columnMinima.assign(size, none);
+    std::size_t rowBound = 0;
+    for (std::size_t row = 0; row < size; row++) {
+        auto u = _order[depth + row];
+        auto rowMinimum = none;
+        for (std::size_t w = 0, column = 0; w < _n; w++) {
+            if (_used[w]) continue;
+            // the sorted sequences are paired in order, which minimises the difference over all pairings
+            auto cost = 2 * costs[u * _n + w] + absDiffSum(&rowsG[u * _n], &rowsH[w * _n], size - 1) +
+                        absDiffSum(&columnsG[u * _n], &columnsH[w * _n], size - 1);
+            _boundCosts[row * size + column] = cost;
+            rowMinimum = std::min(rowMinimum, cost);
+            _columnMinima[column] = std::min(_columnMinima[column], cost);
+            column++;
+        }
+        rowBound += rowMinimum;
+    }
+
+    // the cheapest image of every row, or of every column, is often enough to cut the branch
+    std::size_t columnBound = 0;
+    for (auto minimum : _columnMinima)
+        columnBound += minimum;
+    auto bound = (std::max(rowBound, columnBound) + 1) / 2;
+    if (bound >= budget) return bound;
+
+    return (_assignmentSolver.solve(_boundCosts, size) + 1) / 2;
+}
+
+void BranchAndBound::seed(std::vector<vertex> mapping) {
+    _bestAssignment = std::move(mapping);
+}
+
+bool BranchAndBound::expired() const {
+    return _expired;
+}
+
+const std::vector<vertex>& BranchAndBound::mapping() const {
+    return _bestAssignment;
+}
+
+std::size_t BranchAndBound::best() const {
+    return _sharedBest ? _sharedBest->load(std::memory_order_relaxed) : _best;
+}
+
+void BranchAndBound::improve(std::size_t cost) {
+    if (cost < _best) {
+        _best = cost;
+        _bestAssignment = _assignment;
+    }
+    if (!_sharedBest) return;
+    auto current = _sharedBest->load(std::memory_order_relaxed);
+    while (cost < current && !_sharedBest->compare_exchange_weak(current, cost, std::memory_order_relaxed)) {
+    }
+}
+
+bool BranchAndBound::outOfBudget() {
+    if (_expired) return true;
+    if (_nodeLimit != 0) {
+        const auto nodes = _sharedNodes ? _sharedNodes->fetch_add(1, std::memory_order_relaxed) : _nodes++;
+        if (nodes >= _nodeLimit) return _expired = true;
+    }
+    _expired = std::chrono::steady_clock::now() >= _deadline;
+    return _expired;
+}
+
+void BranchAndBound::search(std::size_t depth, std::size_t cost) {
+    if (depth == _n) {
+        improve(cost);
+        return;
+    }
+
+    auto u = _order[depth];
+    auto& candidates = _candidates[depth];
+    candidates.clear();
+    bool paddingTried = false;
+    for (vertex w = 0; w < _n; w++) {
+        if (_used[w]) continue;
+        // the isolated padding vertices are interchangeable, mapping u onto one of them covers all
+        if (w >= _m) {
+            if (paddingTried) continue;
+            paddingTried = true;
+        }
+        candidates.emplace_back(_costs[depth][u * _n + w], w);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (auto [added, w] : candidates) {
+        // other workers may lower the best cost at any time, read it once per branch
+        auto bound = best();
+        if (cost + added >= bound || bound <= _knownLowerBound || outOfBudget()) break;
+        _used[w] = true;
+        _assignment[u] = w;
+        assign(depth, u, w);
+        if (added + lowerBound(depth + 1, bound - cost - added) < bound - cost) search(depth + 1, cost + added);
+        _used[w] = false;
+    }
+}
+
+std::vector<std::vector<vertex>> BranchAndBound::prefixes(std::size_t depth) const {
+    auto result = std::vector<std::vector<vertex>>{{}};
+    for (std::size_t d = 0; d < depth; d++) {
+        auto extended = std::vector<std::vector<vertex>>();
+        for (const auto& prefix : result) {
+            auto used = std::vector<bool>(_n);
+            for (auto w : prefix)
+                used[w] = true;
+            bool paddingTried = false;
+            for (vertex w = 0; w < _n; w++) {
+                if (used[w]) continue;
+                if (w >= _m) {
+                    if (paddingTried) continue;
+                    paddingTried = true;
+                }
+                extended.push_back(prefix);
+                extended.back().push_back(w);
+            }
+        }
+        result = std::move(extended);
+    }
+    return result;
+}
+
+void BranchAndBound::searchPrefix(const std::vector<vertex>& images) {
+    if (best() <= _knownLowerBound || outOfBudget()) return;
+    std::size_t cost = 0;
+    std::size_t depth = 0;
+    for (; depth < images.size(); depth++) {
+        auto u = _order[depth];
+        auto w = images[depth];
+        auto added = _costs[depth][u * _n + w];
+        if (cost + added >= best()) break;
+        _used[w] = true;
+        _assignment[u] = w;
+        assign(depth, u, w);
+        cost += added;
+    }
+
+    if (depth == images.size()) {
+        auto bound = best();
+        if (cost < bound && lowerBound(depth, bound - cost) < bound - cost) search(depth, cost);
+    }
+    for (std::size_t d = 0; d < depth; d++)
+        _used[images[d]] = false;
+}
+
+std::size_t BranchAndBound::solve(unsigned int threads, std::size_t knownLowerBound,
+                                  std::chrono::steady_clock::time_point deadline, std::size_t nodeLimit) {
+    _knownLowerBound = knownLowerBound;
+    _deadline = deadline;
+    _nodeLimit = nodeLimit;
+    _nodes = 0;
+    _expired = false;
+    if (_bestAssignment.empty()) _bestAssignment = heuristicMapping();
+    _best = mappingCost(_graphs, _bestAssignment);
+    if (_n == 0 || _best <= _knownLowerBound || lowerBound(0, _best) >= _best) return _best;
+
+    threads = core::resolveThreadCount(threads);
+    if (threads <= 1) {
+        search(0, 0);
+        // a search stopped by the deadline may still have reached the known bound
+        _expired = _expired && _best > _knownLowerBound;
+        return _best;
+    }
+
+    // enough subtrees for the workers to even out, subtree sizes vary a lot
+    std::size_t depth = 0;
+    for (std::size_t count = 1; depth + 1 < _n && count < 16 * threads; depth++)
+        count *= _n - depth;
+    const auto tasks = prefixes(depth);
+
+    std::atomic<std::size_t> sharedBest{_best};
+    std::atomic<std::size_t> sharedNodes{0};
+    std::vector<std::unique_ptr<BranchAndBound>> idle;
+    std::mutex idleMutex;
+    core::parallelFor(tasks.size(), threads, [&](std::size_t i) {
+        std::unique_ptr<BranchAndBound> worker;
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            if (!idle.empty()) {
+                worker = std::move(idle.back());
+                idle.pop_back();
+            }
+        }
+        if (!worker) {
+            worker = std::make_unique<BranchAndBound>(*this);
+            worker->_sharedBest = &sharedBest;
+            worker->_sharedNodes = &sharedNodes;
+        }
+        worker->searchPrefix(tasks[i]);
+        std::lock_guard<std::mutex> lock(idleMutex);
+        idle.push_back(std::move(worker));
+    });
+
+    // the workers improved on the shared best one after another, the one holding the lowest cost found it
+    for (const auto& worker : idle) {
+        _expired = _expired || worker->_expired;
+        if (worker->_best < _best) {
+            _best = worker->_best;
+            _bestAssignment = worker->_bestAssignment;
+        }
+    }
+    _expired = _expired && _best > _knownLowerBound;
+    return _best;
+}
+
+} // namespace metric
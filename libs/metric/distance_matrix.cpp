@@ -0,0 +1,101 @@
+#include "distance_matrix.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace metric
+{
+
+static std::vector<CachedGraph> withSignatures(std::vector<core::Multigraph> graphs) {
+    std::vector<CachedGraph> result;
+    result.reserve(graphs.size());
+    for (auto& graph : graphs)
+        result.emplace_back(std::move(graph));
+    return result;
+}
+
+DistanceMatrix::DistanceMatrix(std::vector<core::Multigraph> graphs) : _rows(withSignatures(std::move(graphs))) {
+}
+
+DistanceMatrix::DistanceMatrix(std::vector<core::Multigraph> rows, std::vector<core::Multigraph> columns)
+    : _rows(withSignatures(std::move(rows))), _columns(withSignatures(std::move(columns))) {
+}
+
+const std::vector<CachedGraph>& DistanceMatrix::columns() const {
+    return symmetric() ? _rows : _columns;
+}
+
+std::size_t DistanceMatrix::rowCount() const {
+    return _rows.size();
+}
+
+std::size_t DistanceMatrix::columnCount() const {
+    return columns().size();
+}
+
+bool DistanceMatrix::symmetric() const {
+    return _columns.empty();
+}
+
+void DistanceMatrix::compute(const Metric& metric, unsigned int threads, const RowOutput& output) const {
+    const auto& columnGraphs = columns();
+    const auto columnCount = columnGraphs.size();
+    if (columnCount == 0) {
+        for (std::size_t row = 0; row < _rows.size(); row++)
+            output(row, {});
+        return;
+    }
+
+    // enough pairs per block to keep every worker busy
+    const auto workers = core::resolveThreadCount(threads);
+    const auto blockRows = std::max<std::size_t>(1, (64 * workers + columnCount - 1) / columnCount);
+
+    // a single collection keeps the rows already computed, their columns fill the lower triangle of later rows
+    std::vector<std::vector<std::size_t>> computed;
+    std::vector<std::vector<std::size_t>> block;
+    for (std::size_t first = 0; first < _rows.size(); first += blockRows) {
+        const auto rows = std::min(blockRows, _rows.size() - first);
+        block.assign(rows, std::vector<std::size_t>(columnCount, 0));
+
+        core::parallelFor(rows * columnCount, threads, [&](std::size_t pair) {
+            auto row = first + pair / columnCount;
+            auto column = pair % columnCount;
+            if (symmetric() && column <= row) return;
+            block[pair / columnCount][column] = metric.distance(_rows[row], columnGraphs[column]);
+        });
+
+        for (std::size_t i = 0; i < rows; i++) {
+            auto row = first + i;
+            if (symmetric()) {
+                for (std::size_t column = 0; column < row; column++)
+                    block[i][column] = computed[column][row];
+            }
+            output(row, block[i]);
+            if (symmetric()) computed.push_back(std::move(block[i]));
+        }
+    }
+}
+
+void DistanceMatrix::nearest(const Metric& metric, unsigned int threads, std::size_t k,
+                             const NeighbourOutput& output) const {
+    std::vector<std::pair<std::size_t, std::size_t>> neighbours;
+    compute(metric, threads, [&](std::size_t row, const std::vector<std::size_t>& distances) {
+        // ordered by distance, ties by column
+        std::vector<std::pair<std::size_t, std::size_t>> candidates;
+        for (std::size_t column = 0; column < distances.size(); column++) {
+            if (symmetric() && column == row) continue;
+            candidates.emplace_back(distances[column], column);
+        }
+        auto count = std::min(k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+
+        neighbours.clear();
+        for (std::size_t i = 0; i < count; i++)
+            neighbours.emplace_back(candidates[i].second, candidates[i].first);
+        output(row, neighbours);
+    });
+}
+
+} // namespace metric
@@ -0,0 +1,200 @@
+#include "graph_signature.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace metric
+{
+
+inline static std::size_t absDiff(std::size_t a, std::size_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// order-dependent combination of two hashes, finished with the splitmix64 mixer
+static std::uint64_t mix(std::uint64_t seed, std::uint64_t value) {
+    auto x = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static std::size_t distinctCount(std::vector<std::uint64_t> colours) {
+    std::sort(colours.begin(), colours.end());
+    return std::unique(colours.begin(), colours.end()) - colours.begin();
+}
+
+// Colour refinement: a vertex starts coloured by its loop and degrees, then repeatedly takes the colour of its old
+// colour together with the multisets of (multiplicity, colour) over its out- and in-neighbours, until a round splits
+// no colour class. Colours never depend on labels, so isomorphic graphs refine identically.
+static std::vector<std::uint64_t> refineColours(const core::Multigraph& graph) {
+    const auto n = graph.vertexCount();
+    const auto view = graph.view();
+    auto colours = std::vector<std::uint64_t>(n);
+    for (vertex v = 0; v < n; v++)
+        colours[v] = mix(mix(view(v, v), graph.outDegree(v)), graph.inDegree(v));
+
+    auto count = distinctCount(colours);
+    auto next = std::vector<std::uint64_t>(n);
+    std::vector<std::pair<std::size_t, std::uint64_t>> outNeighbours;
+    std::vector<std::pair<std::size_t, std::uint64_t>> inNeighbours;
+    for (std::size_t round = 0; round < n && count < n; round++) {
+        for (vertex v = 0; v < n; v++) {
+            outNeighbours.clear();
+            inNeighbours.clear();
+            for (vertex w = 0; w < n; w++) {
+                if (w == v) continue;
+                if (view(v, w) > 0) outNeighbours.emplace_back(view(v, w), colours[w]);
+                if (view(w, v) > 0) inNeighbours.emplace_back(view(w, v), colours[w]);
+            }
+            std::sort(outNeighbours.begin(), outNeighbours.end());
+            std::sort(inNeighbours.begin(), inNeighbours.end());
+
+            auto colour = mix(colours[v], outNeighbours.size());
+            for (auto [edges, neighbour] : outNeighbours)
+                colour = mix(mix(colour, edges), neighbour);
+            colour = mix(colour, inNeighbours.size());
+            for (auto [edges, neighbour] : inNeighbours)
+                colour = mix(mix(colour, edges), neighbour);
+            next[v] = colour;
+        }
+        colours.swap(next);
+
+        auto nextCount = distinctCount(colours);
+        if (nextCount == count) break;
+        count = nextCount;
+    }
+    return colours;
+}
+
+GraphSignature::GraphSignature(const core::Multigraph& graph)
+    : _vertexCount(graph.vertexCount()), _edgeCount(0), _outDegrees(_vertexCount), _inDegrees(_vertexCount),
+      _colours(refineColours(graph)) {
+    const auto view = graph.view();
+    for (vertex u = 0; u < _vertexCount; u++) {
+        _outDegrees[u] = graph.outDegree(u);
+        _inDegrees[u] = graph.inDegree(u);
+        _edgeCount += _outDegrees[u];
+        for (vertex v = 0; v < _vertexCount; v++) {
+            if (view(u, v) > 0) _multiplicities[view(u, v)]++;
+        }
+    }
+    std::sort(_outDegrees.begin(), _outDegrees.end(), std::greater<>());
+    std::sort(_inDegrees.begin(), _inDegrees.end(), std::greater<>());
+
+    auto sortedColours = _colours;
+    std::sort(sortedColours.begin(), sortedColours.end());
+    _hash = mix(_vertexCount, _edgeCount);
+    for (auto colour : sortedColours)
+        _hash = mix(_hash, colour);
+}
+
+std::size_t GraphSignature::vertexCount() const {
+    return _vertexCount;
+}
+
+std::size_t GraphSignature::edgeCount() const {
+    return _edgeCount;
+}
+
+const std::vector<std::size_t>& GraphSignature::outDegrees() const {
+    return _outDegrees;
+}
+
+const std::vector<std::size_t>& GraphSignature::inDegrees() const {
+    return _inDegrees;
+}
+
+const std::vector<std::uint64_t>& GraphSignature::colours() const {
+    return _colours;
+}
+
+std::uint64_t GraphSignature::hash() const {
+    return _hash;
+}
+
+// difference of two decreasing sequences paired in order, the shorter one padded with zeros
+static std::size_t sortedDifference(const std::vector<std::size_t>& a, const std::vector<std::size_t>& b) {
+    const auto& longer = a.size() >= b.size() ? a : b;
+    const auto& shorter = a.size() >= b.size() ? b : a;
+    auto difference = absDiffSum(longer.data(), shorter.data(), shorter.size());
+    return std::accumulate(longer.begin() + shorter.size(), longer.end(), difference);
+}
+
+// The same for the multisets of all entries of both adjacency matrices, padded to `entries` with zeros and walked in
+// increasing order straight from their histograms.
+static std::size_t histogramDifference(const std::map<std::size_t, std::size_t>& a,
+                                       const std::map<std::size_t, std::size_t>& b, std::size_t entries) {
+    auto zeros = [entries](const std::map<std::size_t, std::size_t>& histogram) {
+        std::size_t nonZero = 0;
+        for (auto [edges, count] : histogram)
+            nonZero += count;
+        return entries - nonZero;
+    };
+    std::size_t valueA = 0, leftA = zeros(a);
+    std::size_t valueB = 0, leftB = zeros(b);
+    auto nextA = a.begin();
+    auto nextB = b.begin();
+
+    std::size_t difference = 0;
+    while (true) {
+        while (leftA == 0 && nextA != a.end())
+            std::tie(valueA, leftA) = *nextA++;
+        while (leftB == 0 && nextB != b.end())
+            std::tie(valueB, leftB) = *nextB++;
+        if (leftA == 0 || leftB == 0) return difference;
+
+        auto paired = std::min(leftA, leftB);
+        difference += paired * absDiff(valueA, valueB);
+        leftA -= paired;
+        leftB -= paired;
+    }
+}
+
+std::size_t GraphSignature::lowerBound(const GraphSignature& a, const GraphSignature& b) {
+    const auto n = std::max(a._vertexCount, b._vertexCount);
+    const auto bound = std::max({sortedDifference(a._outDegrees, b._outDegrees),
+                                 sortedDifference(a._inDegrees, b._inDegrees),
+                                 histogramDifference(a._multiplicities, b._multiplicities, n * n)});
+    return absDiff(a._vertexCount, b._vertexCount) + bound;
+}
+
+CachedGraph::CachedGraph(core::Multigraph graph) : graph(std::move(graph)), signature(this->graph) {
+}
+
+bool provenIsomorphic(const CachedGraph& G, const CachedGraph& H) {
+    const auto& a = G.signature;
+    const auto& b = H.signature;
+    if (a.vertexCount() != b.vertexCount() || a.edgeCount() != b.edgeCount() || a.hash() != b.hash()) return false;
+
+    const auto n = a.vertexCount();
+    const auto viewG = G.graph.view();
+    const auto viewH = H.graph.view();
+    if (std::equal(viewG.data_handle(), viewG.data_handle() + n * n, viewH.data_handle())) return true;
+
+    // pair the vertices of equal colour, unique when every colour class is a single vertex
+    auto byColour = [](const std::vector<std::uint64_t>& colours) {
+        auto order = std::vector<vertex>(colours.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](vertex x, vertex y) { return colours[x] < colours[y]; });
+        return order;
+    };
+    const auto orderG = byColour(a.colours());
+    const auto orderH = byColour(b.colours());
+    auto mapping = std::vector<vertex>(n);
+    for (std::size_t i = 0; i < n; i++)
+        mapping[orderG[i]] = orderH[i];
+
+    for (vertex u = 0; u < n; u++) {
+        for (vertex v = 0; v < n; v++) {
+            if (viewG(u, v) != viewH(mapping[u], mapping[v])) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace metric
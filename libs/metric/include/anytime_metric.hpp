@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core.hpp"
+#include "metric.hpp"
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace metric
+{
+
+// Largest vertex count for which AnytimeMetric runs BranchAndBound. Its per-depth tables take O(n^3) memory and
+// setup time, and beyond this size it rarely proves anything within a request's latency.
+const std::size_t ANYTIME_BRANCH_AND_BOUND_MAX_VERTICES = 32;
+
+// What an anytime search knows about a distance when its budget runs out.
+struct DistanceBounds {
+    std::size_t lowerBound;
+    // distance under mapping, equal to lowerBound when optimal
+    std::size_t upperBound;
+    // Image in H of every vertex of G. Vertices of G mapped to H's vertex count or beyond are deleted. When G is the
+    // smaller graph, the H vertices nobody maps to are deleted instead.
+    std::vector<vertex> mapping;
+    bool optimal;
+};
+
+// Distance with a latency guarantee. The signature assignment gives a first mapping and a lower bound, then the
+// remaining budget goes to BranchAndBound on small graphs, which either proves the optimum or stops when the budget
+// runs out, and to iterated local search on large ones: random swaps kick the best mapping out of its local minimum
+// and swap descent with O(n) deltas brings it down again. The first mapping is always computed, so a budget below its
+// O(n^3) cost is exceeded by that much.
+class AnytimeMetric : public Metric {
+  private:
+    std::chrono::steady_clock::duration _timeLimit;
+    std::size_t _iterationLimit;
+
+  public:
+    // The iteration limit stops BranchAndBound after that many branches on small graphs and the local search after that
+    // many kicks on large ones, a zero iteration limit runs either until the time limit. At least one of them must be
+    // set.
+    AnytimeMetric(std::chrono::steady_clock::duration timeLimit, std::size_t iterationLimit = 0);
+
+    DistanceBounds bounds(const core::Multigraph& G, const core::Multigraph& H) const;
+    // upper bound of bounds(G, H)
+    std::size_t operator()(const core::Multigraph& G, const core::Multigraph& H) const override;
+    // the signature bound of ExactMetric, which this metric never goes below
+    std::size_t lowerBound(const CachedGraph& G, const CachedGraph& H) const override;
+};
+
+} // namespace metric
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace metric
+{
+
+// Hungarian method (shortest augmenting paths with potentials) for the linear assignment problem on a dense square
+// cost matrix, O(size^3). Buffers are kept between calls so that repeated solves do not allocate.
+class AssignmentSolver {
+  private:
+    std::vector<std::int64_t> _rowPotential;
+    std::vector<std::int64_t> _columnPotential;
+    std::vector<std::size_t> _columnMatch;
+    std::vector<std::size_t> _way;
+    std::vector<std::int64_t> _minimum;
+    std::vector<bool> _visited;
+    std::vector<std::size_t> _assignment;
+
+  public:
+    // minimal sum of costs[row * size + assignment[row]] over permutations of the columns
+    std::size_t solve(std::span<const std::size_t> costs, std::size_t size);
+    // column assigned to every row by the last solve
+    const std::vector<std::size_t>& assignment() const;
+};
+
+} // namespace metric
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "core.hpp"
+#include "mapping_cost.hpp"
+#include "metric.hpp"
+#include <vector>
+
+namespace metric
+{
+
+// Maps every vertex of G onto the vertex of H whose signature, its sorted out-row and in-column multiplicities and
+// its loop, is the closest, solving the linear assignment problem over these costs in O(n^3). Returns half the optimal
+// assignment cost rounded up, a lower bound of the edge difference of every mapping (the root bound of
+// BranchAndBound).
+std::size_t signatureAssignment(const PaddedPair& graphs, std::vector<vertex>& assignment);
+
+// Linearises the edge difference around the current mapping: u -> w is charged its row and column differences with
+// every other vertex kept on its current image. Re-solving the assignment over these costs moves many vertices at
+// once, which single swaps cannot, and is repeated while it lowers the true cost.
+void refineAssignment(const PaddedPair& graphs, std::vector<vertex>& assignment);
+
+// Upper bound metric: the true edge difference under the signature assignment, refined by re-solving the assignment
+// problem around the current mapping and optionally by vertex swaps. Unlike HeuristicMetric it never underestimates
+// the distance and is usually close to ExactMetric, at O(n^3) per refinement round.
+class AssignmentMetric : public Metric {
+  private:
+    bool _localSearch;
+
+  public:
+    AssignmentMetric(bool localSearch = true);
+
+    // the mapping of G onto the padded H whose edge difference the metric reports
+    std::vector<vertex> mapping(const PaddedPair& graphs) const;
+    std::size_t operator()(const core::Multigraph& G, const core::Multigraph& H) const override;
+    // the signature bound of ExactMetric, which this metric never goes below
+    std::size_t lowerBound(const CachedGraph& G, const CachedGraph& H) const override;
+};
+
+} // namespace metric
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "assignment.hpp"
+#include "core.hpp"
+#include "mapping_cost.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace metric
+{
+
+// Branch-and-bound search for the vertex mapping of G onto H (padded with isolated vertices up to G's size) that
+// minimises the summed edge multiplicity difference. Vertices of G are assigned one at a time and a branch is cut as
+// soon as its cost plus a lower bound for the unassigned vertices reaches the best mapping found so far.
+//
+// The bound generalises the degree-sequence bound of HeuristicMetric to single rows: an unassigned u mapped onto an
+// unused w pays exactly for its loop and its arcs to the assigned vertices, and at least the sorted difference of its
+// remaining row (and column) multiplicities with those of w for the rest. The assignment problem over these costs
+// bounds every completion of the partial mapping from below.
+class BranchAndBound {
+  private:
+    std::size_t _n;
+    std::size_t _m;
+    PaddedPair _graphs;
+    // G vertices in assignment order
+    std::vector<vertex> _order;
+
+    // Per depth d, n x n slots holding for every unassigned G vertex (unused H vertex) its multiplicities to the
+    // other n - d - 1 unassigned (unused) vertices in increasing order, by row and by column.
+    std::vector<std::vector<std::size_t>> _sortedRowsG;
+    std::vector<std::vector<std::size_t>> _sortedColumnsG;
+    std::vector<std::vector<std::size_t>> _sortedRowsH;
+    std::vector<std::vector<std::size_t>> _sortedColumnsH;
+    // per depth, row-major cost of mapping an unassigned u onto an unused w: its loop and its arcs to assigned vertices
+    std::vector<std::vector<std::size_t>> _costs;
+
+    std::vector<vertex> _assignment;
+    std::vector<bool> _used;
+    std::vector<std::vector<std::pair<std::size_t, vertex>>> _candidates;
+    std::vector<std::size_t> _boundCosts;
+    std::vector<std::size_t> _columnMinima;
+    AssignmentSolver _assignmentSolver;
+    std::size_t _best;
+    // mapping of cost _best, empty until the first solve or seed
+    std::vector<vertex> _bestAssignment;
+    // no mapping costs less, reaching it ends the search
+    std::size_t _knownLowerBound = 0;
+    std::chrono::steady_clock::time_point _deadline = std::chrono::steady_clock::time_point::max();
+    // branches the solve may take, 0 for no limit
+    std::size_t _nodeLimit = 0;
+    std::size_t _nodes = 0;
+    bool _expired = false;
+    // best cost over all workers of a parallel solve, null when solving on one thread
+    std::atomic<std::size_t>* _sharedBest = nullptr;
+    // branches taken by all workers of a parallel solve, null when solving on one thread
+    std::atomic<std::size_t>* _sharedNodes = nullptr;
+
+    std::vector<vertex> heuristicMapping() const;
+    void assign(std::size_t depth, vertex u, vertex w);
+    // stops at the cheap row and column bound when it already reaches the budget
+    std::size_t lowerBound(std::size_t depth, std::size_t budget);
+    std::size_t best() const;
+    void improve(std::size_t cost);
+    // checked and counted once per branch, the clock is cheap next to the O(n^3) bound every branch computes
+    bool outOfBudget();
+    void search(std::size_t depth, std::size_t cost);
+    // all mappings of the first `depth` vertices in assignment order, as images in that order
+    std::vector<std::vector<vertex>> prefixes(std::size_t depth) const;
+    void searchPrefix(const std::vector<vertex>& images);
+
+  public:
+    // G must have at least as many vertices as H
+    BranchAndBound(const core::Multigraph& G, const core::Multigraph& H);
+
+    // edge difference of the AssignmentMetric mapping, an upper bound of the optimum
+    std::size_t upperBound() const;
+    // starts the next solve from this mapping of G onto the padded H instead of the AssignmentMetric one
+    void seed(std::vector<vertex> mapping);
+    // Minimal edge difference over all vertex mappings. With more than one thread (0 meaning one per hardware thread)
+    // the search tree is cut into the subtrees below fixed prefixes of the mapping, which workers claim from a shared
+    // counter while sharing the best cost found so far. A mapping reaching knownLowerBound, a bound of the edge
+    // difference found elsewhere, ends the search. At the deadline, or after nodeLimit branches when that is not 0,
+    // the search gives up and returns the best cost found so far, which is then only an upper bound.
+    std::size_t solve(unsigned int threads = 1, std::size_t knownLowerBound = 0,
+                      std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+                      std::size_t nodeLimit = 0);
+    // whether the last solve stopped at its deadline or node limit
+    bool expired() const;
+    // image in H of every vertex of G under a mapping of the cost the last solve returned
+    const std::vector<vertex>& mapping() const;
+};
+
+} // namespace metric
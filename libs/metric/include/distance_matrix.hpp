@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core.hpp"
+#include "graph_signature.hpp"
+#include "metric.hpp"
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace metric
+{
+
+// Distances between every graph of one collection and every graph of another, or between all graphs of a single
+// collection. Every graph is wrapped in a CachedGraph once, so each pair goes through Metric::distance, which reads
+// degrees from the cached signatures and skips pairs they prove isomorphic, the bulk of deduplication jobs.
+class DistanceMatrix {
+  public:
+    using RowOutput = std::function<void(std::size_t row, const std::vector<std::size_t>& distances)>;
+    using NeighbourOutput =
+        std::function<void(std::size_t row, const std::vector<std::pair<std::size_t, std::size_t>>& neighbours)>;
+
+  private:
+    std::vector<CachedGraph> _rows;
+    // empty for a single collection, whose distances are symmetric and computed once per unordered pair
+    std::vector<CachedGraph> _columns;
+
+    const std::vector<CachedGraph>& columns() const;
+
+  public:
+    DistanceMatrix(std::vector<core::Multigraph> graphs);
+    DistanceMatrix(std::vector<core::Multigraph> rows, std::vector<core::Multigraph> columns);
+
+    std::size_t rowCount() const;
+    std::size_t columnCount() const;
+    bool symmetric() const;
+
+    // Computes the matrix in blocks of rows, the pairs of a block in parallel on `threads` workers (0 meaning one per
+    // hardware thread), and passes every row to output in increasing order as soon as its block is done. The metric
+    // is shared by the workers and must be safe to call concurrently.
+    void compute(const Metric& metric, unsigned int threads, const RowOutput& output) const;
+    // the k nearest columns of every row as (column, distance) pairs, closest first; in a single collection a graph
+    // is not its own neighbour
+    void nearest(const Metric& metric, unsigned int threads, std::size_t k, const NeighbourOutput& output) const;
+};
+
+} // namespace metric
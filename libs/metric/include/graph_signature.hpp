@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace metric
+{
+
+// Relabelling-invariant summary of a multigraph: its sorted degree sequences, the histogram of its edge
+// multiplicities and a Weisfeiler-Lehman colour refinement hash. Computed once per graph, it bounds the distance to
+// any other graph without looking at either adjacency matrix again.
+class GraphSignature {
+  private:
+    std::size_t _vertexCount;
+    std::size_t _edgeCount;
+    // in decreasing order
+    std::vector<std::size_t> _outDegrees;
+    std::vector<std::size_t> _inDegrees;
+    // number of ordered vertex pairs, loops included, joined by exactly m > 0 edges
+    std::map<std::size_t, std::size_t> _multiplicities;
+    // stable colour of every vertex after refinement, equal for vertices an isomorphism may exchange
+    std::vector<std::uint64_t> _colours;
+    std::uint64_t _hash;
+
+  public:
+    GraphSignature(const core::Multigraph& graph);
+
+    std::size_t vertexCount() const;
+    std::size_t edgeCount() const;
+    const std::vector<std::size_t>& outDegrees() const;
+    const std::vector<std::size_t>& inDegrees() const;
+    const std::vector<std::uint64_t>& colours() const;
+    // equal for isomorphic graphs, different hashes prove the graphs are not isomorphic
+    std::uint64_t hash() const;
+
+    // Lower bound of the distance between the signed graphs: the vertex count difference plus the largest of the
+    // sorted out-degree, in-degree and multiplicity differences, which no vertex mapping can avoid.
+    static std::size_t lowerBound(const GraphSignature& a, const GraphSignature& b);
+};
+
+// A graph wrapped in StatisticsTrackingGraph together with its signature, both computed once and shared by every
+// comparison the graph takes part in.
+struct CachedGraph {
+    core::StatisticsTrackingGraph graph;
+    GraphSignature signature;
+
+    CachedGraph(core::Multigraph graph);
+};
+
+// True when the graphs are shown to be isomorphic, either equal or mapped onto each other by their vertex colours.
+// False means not proven: graphs whose refinement leaves several vertices of one colour are not searched further.
+bool provenIsomorphic(const CachedGraph& G, const CachedGraph& H);
+
+} // namespace metric
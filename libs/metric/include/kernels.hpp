@@ -0,0 +1,27 @@
+#pragma once
+
+#include "core.hpp"
+#include <cstddef>
+
+namespace metric
+{
+
+// Instruction sets of the edge difference kernels, in increasing width.
+enum class SimdLevel { Scalar, Avx2, Avx512 };
+
+// widest level supported by the running CPU, the one the kernels use unless told otherwise
+SimdLevel detectSimdLevel();
+
+// Edge difference kernels. The overloads taking a level fall back to the detected one when the CPU lacks the requested
+// instruction set.
+
+// sum of |a[i] - b[i]| for i < size
+std::size_t absDiffSum(const std::size_t* a, const std::size_t* b, std::size_t size);
+std::size_t absDiffSum(const std::size_t* a, const std::size_t* b, std::size_t size, SimdLevel level);
+
+// sum of |a[i] - row[index[i]]| for i < size, comparing a row with a permuted one
+std::size_t absDiffSumGathered(const std::size_t* a, const std::size_t* row, const vertex* index, std::size_t size);
+std::size_t absDiffSumGathered(const std::size_t* a, const std::size_t* row, const vertex* index, std::size_t size,
+                               SimdLevel level);
+
+} // namespace metric
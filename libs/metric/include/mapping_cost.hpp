@@ -0,0 +1,34 @@
+#pragma once
+
+#include "core.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace metric
+{
+
+// G and H as row-major n x n multiplicity matrices, H padded with isolated vertices up to the vertex count of G, the
+// form in which the exact metric engines compare vertex mappings.
+struct PaddedPair {
+    std::size_t n;
+    std::size_t m;
+    std::vector<std::size_t> g;
+    std::vector<std::size_t> h;
+
+    // G must have at least as many vertices as H
+    PaddedPair(const core::Multigraph& G, const core::Multigraph& H);
+};
+
+// sum over all vertex pairs (u, v) of |G(u, v) - H(assignment[u], assignment[v])|
+std::size_t mappingCost(const PaddedPair& graphs, std::span<const vertex> assignment);
+
+// Change of mappingCost when the images of a and b are exchanged. Only rows and columns a and b are affected, so
+// this takes O(n) instead of the O(n^2) of a full evaluation.
+std::int64_t swapDelta(const PaddedPair& graphs, std::span<const vertex> assignment, vertex a, vertex b);
+
+// exchanges images of vertex pairs while that lowers mappingCost, until no single swap does
+void improveBySwaps(const PaddedPair& graphs, std::vector<vertex>& assignment);
+
+} // namespace metric
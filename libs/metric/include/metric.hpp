@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core.hpp"
+#include "graph_signature.hpp"
 
 namespace metric
 {
@@ -8,11 +9,26 @@ namespace metric
 class Metric {
   public:
     virtual std::size_t operator()(const core::Multigraph& G, const core::Multigraph& H) const = 0;
+    // The same distance for graphs with cached signatures. Pairs the signatures prove isomorphic are 0 without
+    // running the metric.
+    virtual std::size_t distance(const CachedGraph& G, const CachedGraph& H) const;
+    // Cheap bound no greater than distance(G, H), for skipping pairs that cannot be close. The vertex count
+    // difference unless a metric knows better.
+    virtual std::size_t lowerBound(const CachedGraph& G, const CachedGraph& H) const;
 };
 
 class ExactMetric : public Metric {
+  private:
+    unsigned int _threads;
+
   public:
+    // threads is the number of search workers, 0 meaning one per hardware thread
+    ExactMetric(unsigned int threads = 1);
     std::size_t operator()(const core::Multigraph& G, const core::Multigraph& H) const override;
+    // also stops the search as soon as a mapping meets the signature lower bound
+    std::size_t distance(const CachedGraph& G, const CachedGraph& H) const override;
+    // the degree and multiplicity bound of the signatures
+    std::size_t lowerBound(const CachedGraph& G, const CachedGraph& H) const override;
 };
 
 class HeuristicMetric : public Metric {
@@ -24,6 +40,10 @@ class HeuristicMetric : public Metric {
   public:
     HeuristicMetric(bool useCountingSort);
     std::size_t operator()(const core::Multigraph& G, const core::Multigraph& H) const override;
+    // reads the sorted out-degrees of the signatures instead of sorting them for every pair
+    std::size_t distance(const CachedGraph& G, const CachedGraph& H) const override;
+    // the distance itself, it already costs only O(n) on cached signatures
+    std::size_t lowerBound(const CachedGraph& G, const CachedGraph& H) const override;
 };
 
 } // namespace metric
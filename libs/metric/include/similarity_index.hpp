@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core.hpp"
+#include "graph_signature.hpp"
+#include "metric.hpp"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace metric
+{
+
+// Answer of a similarity query together with the work it took.
+struct SearchResult {
+    // (graph index, distance) pairs, closest first, ties by index
+    std::vector<std::pair<std::size_t, std::size_t>> neighbours;
+    // full metric evaluations the query ran, the other size() - evaluations graphs were ruled out by bounds alone
+    std::size_t evaluations = 0;
+};
+
+// Vantage-point tree over a collection of multigraphs. Every node splits the graphs below it by their distance to
+// its vantage graph around the median, so a query prunes whole subtrees with the triangle inequality. Before any
+// full evaluation the metric's lowerBound on the cached signatures is tried, which rules out a vantage graph, and
+// possibly its inner subtree, without running the metric.
+//
+// Results are exact for metrics that satisfy the triangle inequality, such as ExactMetric and HeuristicMetric. The
+// metric is kept by reference, must outlive the index and must be safe to call concurrently when building on more
+// than one thread.
+class SimilarityIndex {
+  private:
+    const Metric& _metric;
+    std::vector<CachedGraph> _graphs;
+    // Implicit tree: the node over positions [begin, end) has its vantage graph at begin, the graphs within
+    // _radius[begin] of it in [begin + 1, _split[begin]) and the others in [_split[begin], end).
+    std::vector<std::size_t> _order;
+    std::vector<std::size_t> _radius;
+    std::vector<std::size_t> _split;
+    std::size_t _buildEvaluations = 0;
+
+    void build(std::size_t begin, std::size_t end, unsigned int threads);
+    template <typename Collector>
+    void search(std::size_t begin, std::size_t end, const CachedGraph& query, Collector& collector,
+                std::size_t& evaluations) const;
+
+  public:
+    // threads (0 meaning one per hardware thread) compute the distances to every vantage graph in parallel
+    SimilarityIndex(std::vector<core::Multigraph> graphs, const Metric& metric, unsigned int threads = 1);
+
+    std::size_t size() const;
+    // metric evaluations spent building the tree, O(size log size)
+    std::size_t buildEvaluations() const;
+
+    // the k graphs closest to the query
+    SearchResult nearest(const core::Multigraph& query, std::size_t k) const;
+    // all graphs within radius of the query
+    SearchResult within(const core::Multigraph& query, std::size_t radius) const;
+};
+
+} // namespace metric
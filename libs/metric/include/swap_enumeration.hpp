@@ -0,0 +1,27 @@
+#pragma once
+
+#include "core.hpp"
+#include "mapping_cost.hpp"
+#include <cstddef>
+
+namespace metric
+{
+// largest vertex count for which enumerating every mapping is faster than branch and bound
+const std::size_t SWAP_ENUMERATION_MAX_VERTICES = 6;
+
+// Exhaustive search over all n! vertex mappings of G onto H (padded with isolated vertices up to G's size) in the
+// order of Heap's algorithm. Consecutive mappings differ by one transposition, so every step is evaluated with
+// swapDelta in O(n) instead of O(n^2). For small graphs this beats the bookkeeping of BranchAndBound.
+class SwapEnumeration {
+  private:
+    PaddedPair _graphs;
+
+  public:
+    // G must have at least as many vertices as H
+    SwapEnumeration(const core::Multigraph& G, const core::Multigraph& H);
+
+    // minimal edge difference over all vertex mappings
+    std::size_t solve() const;
+};
+
+} // namespace metric
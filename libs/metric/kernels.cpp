@@ -0,0 +1,166 @@
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define TAIO_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace metric
+{
+
+inline static std::size_t absDiff(std::size_t a, std::size_t b) {
+    return a > b ? a - b : b - a;
+}
+
+static std::size_t absDiffSumScalar(const std::size_t* a, const std::size_t* b, std::size_t size) {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < size; i++)
+        sum += absDiff(a[i], b[i]);
+    return sum;
+}
+
+static std::size_t absDiffSumGatheredScalar(const std::size_t* a, const std::size_t* row, const vertex* index,
+                                            std::size_t size) {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < size; i++)
+        sum += absDiff(a[i], row[index[i]]);
+    return sum;
+}
+
+#ifdef TAIO_SIMD_DISPATCH
+// AVX2 has no unsigned 64-bit compare, flipping the sign bit maps it onto the signed one
+__attribute__((target("avx2"))) static __m256i absDiffAvx2(__m256i a, __m256i b) {
+    const auto sign = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+    auto less = _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+    auto difference = _mm256_sub_epi64(a, b);
+    // negates the lanes where a < b: (d ^ -1) - (-1) = -d
+    return _mm256_sub_epi64(_mm256_xor_si256(difference, less), less);
+}
+
+__attribute__((target("avx2"))) static std::size_t horizontalSumAvx2(__m256i sum) {
+    auto half = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    return static_cast<std::size_t>(_mm_cvtsi128_si64(half)) +
+           static_cast<std::size_t>(_mm_extract_epi64(half, 1));
+}
+
+__attribute__((target("avx2"))) static std::size_t absDiffSumAvx2(const std::size_t* a, const std::size_t* b,
+                                                                  std::size_t size) {
+    auto sum = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        sum = _mm256_add_epi64(sum, absDiffAvx2(x, y));
+    }
+    return horizontalSumAvx2(sum) + absDiffSumScalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx2"))) static std::size_t absDiffSumGatheredAvx2(const std::size_t* a,
+                                                                          const std::size_t* row,
+                                                                          const vertex* index, std::size_t size) {
+    auto sum = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        auto positions = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+        auto y = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(row), positions, 8);
+        sum = _mm256_add_epi64(sum, absDiffAvx2(x, y));
+    }
+    return horizontalSumAvx2(sum) + absDiffSumGatheredScalar(a + i, row, index + i, size - i);
+}
+
+// the unmasked reduce/extract/max/min/gather intrinsics start from _mm512_undefined_epi32, which makes GCC 12 warn
+// about uninitialized values, so the kernels below stick to masked or zeroing forms
+__attribute__((target("avx512f"))) static __m512i absDiffAvx512(__m512i x, __m512i y) {
+    return _mm512_mask_sub_epi64(_mm512_sub_epi64(x, y), _mm512_cmplt_epu64_mask(x, y), y, x);
+}
+
+__attribute__((target("avx512f"))) static std::size_t horizontalSumAvx512(__m512i sum) {
+    auto low = _mm512_maskz_extracti64x4_epi64(0xF, sum, 0);
+    auto high = _mm512_maskz_extracti64x4_epi64(0xF, sum, 1);
+    return horizontalSumAvx2(_mm256_add_epi64(low, high));
+}
+
+__attribute__((target("avx512f"))) static std::size_t absDiffSumAvx512(const std::size_t* a, const std::size_t* b,
+                                                                      std::size_t size) {
+    auto sum = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        auto x = _mm512_loadu_si512(a + i);
+        auto y = _mm512_loadu_si512(b + i);
+        sum = _mm512_add_epi64(sum, absDiffAvx512(x, y));
+    }
+    // the tail is handled with a masked load instead of a scalar loop
+    if (i < size) {
+        auto mask = static_cast<__mmask8>((1U << (size - i)) - 1);
+        auto x = _mm512_maskz_loadu_epi64(mask, a + i);
+        auto y = _mm512_maskz_loadu_epi64(mask, b + i);
+        sum = _mm512_add_epi64(sum, absDiffAvx512(x, y));
+    }
+    return horizontalSumAvx512(sum);
+}
+
+__attribute__((target("avx512f"))) static std::size_t absDiffSumGatheredAvx512(const std::size_t* a,
+                                                                              const std::size_t* row,
+                                                                              const vertex* index, std::size_t size) {
+    auto sum = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        auto x = _mm512_loadu_si512(a + i);
+        auto positions = _mm512_loadu_si512(index + i);
+        auto y = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xFF, positions, row, 8);
+        sum = _mm512_add_epi64(sum, absDiffAvx512(x, y));
+    }
+    if (i < size) {
+        auto mask = static_cast<__mmask8>((1U << (size - i)) - 1);
+        auto x = _mm512_maskz_loadu_epi64(mask, a + i);
+        auto positions = _mm512_maskz_loadu_epi64(mask, index + i);
+        auto y = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), mask, positions, row, 8);
+        sum = _mm512_add_epi64(sum, absDiffAvx512(x, y));
+    }
+    return horizontalSumAvx512(sum);
+}
+#endif
+
+SimdLevel detectSimdLevel() {
+#ifdef TAIO_SIMD_DISPATCH
+    static const SimdLevel level = __builtin_cpu_supports("avx512f") ? SimdLevel::Avx512
+                                   : __builtin_cpu_supports("avx2")  ? SimdLevel::Avx2
+                                                                     : SimdLevel::Scalar;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+std::size_t absDiffSum(const std::size_t* a, const std::size_t* b, std::size_t size) {
+    return absDiffSum(a, b, size, detectSimdLevel());
+}
+
+std::size_t absDiffSum(const std::size_t* a, const std::size_t* b, std::size_t size, SimdLevel level) {
+#ifdef TAIO_SIMD_DISPATCH
+    level = std::min(level, detectSimdLevel());
+    if (level == SimdLevel::Avx512) return absDiffSumAvx512(a, b, size);
+    if (level == SimdLevel::Avx2) return absDiffSumAvx2(a, b, size);
+#endif
+    return absDiffSumScalar(a, b, size);
+}
+
+std::size_t absDiffSumGathered(const std::size_t* a, const std::size_t* row, const vertex* index, std::size_t size) {
+    return absDiffSumGathered(a, row, index, size, detectSimdLevel());
+}
+
+std::size_t absDiffSumGathered(const std::size_t* a, const std::size_t* row, const vertex* index, std::size_t size,
+                               SimdLevel level) {
+#ifdef TAIO_SIMD_DISPATCH
+    level = std::min(level, detectSimdLevel());
+    if (level == SimdLevel::Avx512) return absDiffSumGatheredAvx512(a, row, index, size);
+    if (level == SimdLevel::Avx2) return absDiffSumGatheredAvx2(a, row, index, size);
+#endif
+    return absDiffSumGatheredScalar(a, row, index, size);
+}
+
+} // namespace metric
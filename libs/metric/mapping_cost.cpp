@@ -0,0 +1,71 @@
+#include "mapping_cost.hpp"
+#include "kernels.hpp"
+
+#include <utility>
+
+namespace metric
+{
+
+inline static std::int64_t absDiff(std::size_t a, std::size_t b) {
+    return a > b ? a - b : b - a;
+}
+
+PaddedPair::PaddedPair(const core::Multigraph& G, const core::Multigraph& H)
+    : n(G.vertexCount()), m(H.vertexCount()), g(n * n), h(n * n, 0) {
+    const auto viewG = G.view();
+    const auto viewH = H.view();
+    for (vertex u = 0; u < n; u++) {
+        for (vertex v = 0; v < n; v++) {
+            g[u * n + v] = viewG(u, v);
+            if (u < m && v < m) h[u * n + v] = viewH(u, v);
+        }
+    }
+}
+
+std::size_t mappingCost(const PaddedPair& graphs, std::span<const vertex> assignment) {
+    const auto n = graphs.n;
+    std::size_t cost = 0;
+    for (vertex u = 0; u < n; u++) {
+        cost += absDiffSumGathered(&graphs.g[u * n], &graphs.h[assignment[u] * n], assignment.data(), n);
+    }
+    return cost;
+}
+
+std::int64_t swapDelta(const PaddedPair& graphs, std::span<const vertex> assignment, vertex a, vertex b) {
+    const auto n = graphs.n;
+    const auto& g = graphs.g;
+    const auto& h = graphs.h;
+    const auto x = assignment[a];
+    const auto y = assignment[b];
+
+    // the four pairs inside {a, b}
+    std::int64_t delta = absDiff(g[a * n + a], h[y * n + y]) + absDiff(g[b * n + b], h[x * n + x]) +
+                         absDiff(g[a * n + b], h[y * n + x]) + absDiff(g[b * n + a], h[x * n + y]) -
+                         absDiff(g[a * n + a], h[x * n + x]) - absDiff(g[b * n + b], h[y * n + y]) -
+                         absDiff(g[a * n + b], h[x * n + y]) - absDiff(g[b * n + a], h[y * n + x]);
+
+    for (vertex v = 0; v < n; v++) {
+        if (v == a || v == b) continue;
+        const auto z = assignment[v];
+        delta += absDiff(g[a * n + v], h[y * n + z]) - absDiff(g[a * n + v], h[x * n + z]) +
+                 absDiff(g[b * n + v], h[x * n + z]) - absDiff(g[b * n + v], h[y * n + z]) +
+                 absDiff(g[v * n + a], h[z * n + y]) - absDiff(g[v * n + a], h[z * n + x]) +
+                 absDiff(g[v * n + b], h[z * n + x]) - absDiff(g[v * n + b], h[z * n + y]);
+    }
+    return delta;
+}
+
+void improveBySwaps(const PaddedPair& graphs, std::vector<vertex>& assignment) {
+    for (bool improved = true; improved;) {
+        improved = false;
+        for (vertex a = 0; a < graphs.n; a++) {
+            for (vertex b = a + 1; b < graphs.n; b++) {
+                if (swapDelta(graphs, assignment, a, b) >= 0) continue;
+                std::swap(assignment[a], assignment[b]);
+                improved = true;
+            }
+        }
+    }
+}
+
+} // namespace metric
@@ -1,4 +1,7 @@
 #include "metric.hpp"
+#include "branch_and_bound.hpp"
+#include "kernels.hpp"
+#include "swap_enumeration.hpp"
 
 #include <numeric>
 #include <algorithm>
@@ -12,29 +15,40 @@ inline static std::size_t absDiff(std::size_t a, std::size_t b) {
     return a > b ? a - b : b - a;
 }
 
+std::size_t Metric::distance(const CachedGraph& G, const CachedGraph& H) const {
+    if (provenIsomorphic(G, H)) return 0;
+    return (*this)(G.graph, H.graph);
+}
+
+std::size_t Metric::lowerBound(const CachedGraph& G, const CachedGraph& H) const {
+    return absDiff(G.graph.vertexCount(), H.graph.vertexCount());
+}
+
+ExactMetric::ExactMetric(unsigned int threads) : _threads(threads) {
+}
+
 std::size_t ExactMetric::operator()(const core::Multigraph& G, const core::Multigraph& H) const {
     if (G.vertexCount() < H.vertexCount()) return this->operator()(H, G);
 
-    auto n = G.vertexCount();
-    auto m = H.vertexCount();
+    auto offset = G.vertexCount() - H.vertexCount();
+    if (G.vertexCount() <= SWAP_ENUMERATION_MAX_VERTICES) return offset + SwapEnumeration(G, H).solve();
+    return offset + BranchAndBound(G, H).solve(_threads);
+}
 
-    std::size_t minEdgeDifference = std::numeric_limits<std::size_t>::max();
-    std::vector<std::size_t> vertexMap(n);
-    std::iota(vertexMap.begin(), vertexMap.end(), 0);
-
-    do {
-        std::size_t edgeDifference = 0;
-        for (std::size_t u = 0; u < n; u++) {
-            for (std::size_t v = 0; v < n; v++) {
-                edgeDifference += vertexMap[u] < m && vertexMap[v] < m
-                                      ? absDiff(G.edgeCount(u, v), H.edgeCount(vertexMap[u], vertexMap[v]))
-                                      : G.edgeCount(u, v);
-            }
-        }
-        if (edgeDifference < minEdgeDifference) minEdgeDifference = edgeDifference;
-    } while (std::next_permutation(vertexMap.begin(), vertexMap.end()));
+std::size_t ExactMetric::distance(const CachedGraph& G, const CachedGraph& H) const {
+    if (G.graph.vertexCount() < H.graph.vertexCount()) return distance(H, G);
+    if (provenIsomorphic(G, H)) return 0;
 
-    return n - m + minEdgeDifference;
+    auto offset = G.graph.vertexCount() - H.graph.vertexCount();
+    if (G.graph.vertexCount() <= SWAP_ENUMERATION_MAX_VERTICES) {
+        return offset + SwapEnumeration(G.graph, H.graph).solve();
+    }
+    auto bound = GraphSignature::lowerBound(G.signature, H.signature) - offset;
+    return offset + BranchAndBound(G.graph, H.graph).solve(_threads, bound);
+}
+
+std::size_t ExactMetric::lowerBound(const CachedGraph& G, const CachedGraph& H) const {
+    return GraphSignature::lowerBound(G.signature, H.signature);
 }
 
 HeuristicMetric::HeuristicMetric(bool useCountingSort) : _useCountingSort(useCountingSort) {
@@ -64,16 +78,30 @@ std::size_t HeuristicMetric::operator()(const core::Multigraph& G, const core::M
     return n - m + edgeDifferenceCompare(degG, degH);
 }
 
+std::size_t HeuristicMetric::distance(const CachedGraph& G, const CachedGraph& H) const {
+    if (G.graph.vertexCount() < H.graph.vertexCount()) return distance(H, G);
+
+    const auto& degG = G.signature.outDegrees();
+    const auto& degH = H.signature.outDegrees();
+    auto n = degG.size();
+    auto m = degH.size();
+    // both decreasing, so the isolated padding vertices of H pair with the lowest degrees of G
+    auto edgeDifference = absDiffSum(degG.data(), degH.data(), m);
+    for (std::size_t v = m; v < n; v++)
+        edgeDifference += degG[v];
+    return n - m + edgeDifference;
+}
+
+std::size_t HeuristicMetric::lowerBound(const CachedGraph& G, const CachedGraph& H) const {
+    return distance(G, H);
+}
+
 std::size_t HeuristicMetric::edgeDifferenceCompare(std::vector<std::size_t>& degG,
                                                    std::vector<std::size_t>& degH) const {
     std::sort(degG.begin(), degG.end(), std::greater<>());
     std::sort(degH.begin(), degH.end(), std::greater<>());
 
-    std::size_t edgeDifference = 0;
-    for (std::size_t v = 0; v < degG.size(); v++) {
-        edgeDifference += absDiff(degG[v], degH[v]);
-    }
-    return edgeDifference;
+    return absDiffSum(degG.data(), degH.data(), degG.size());
 }
 
 std::size_t HeuristicMetric::edgeDifferenceCount(const std::vector<std::size_t>& degG,
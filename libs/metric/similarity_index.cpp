@@ -0,0 +1,170 @@
+#include "similarity_index.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace metric
+{
+
+SimilarityIndex::SimilarityIndex(std::vector<core::Multigraph> graphs, const Metric& metric, unsigned int threads)
+    : _metric(metric), _order(graphs.size()), _radius(graphs.size(), 0), _split(graphs.size(), 0) {
+    _graphs.reserve(graphs.size());
+    for (auto& graph : graphs)
+        _graphs.emplace_back(std::move(graph));
+    for (std::size_t i = 0; i < _order.size(); i++)
+        _order[i] = i;
+    build(0, _order.size(), threads);
+}
+
+void SimilarityIndex::build(std::size_t begin, std::size_t end, unsigned int threads) {
+    if (begin >= end) return;
+    const auto& vantage = _graphs[_order[begin]];
+    std::vector<std::pair<std::size_t, std::size_t>> distances(end - begin - 1);
+    core::parallelFor(distances.size(), threads, [&](std::size_t i) {
+        auto graph = _order[begin + 1 + i];
+        distances[i] = {_metric.distance(vantage, _graphs[graph]), graph};
+    });
+    _buildEvaluations += distances.size();
+    if (distances.empty()) {
+        _split[begin] = end;
+        return;
+    }
+
+    // the median and everything up to it go inside, the rest is at least as far
+    auto median = distances.begin() + (distances.size() - 1) / 2;
+    std::nth_element(distances.begin(), median, distances.end());
+    const auto split = begin + 1 + (median - distances.begin()) + 1;
+    _radius[begin] = median->first;
+    _split[begin] = split;
+    for (std::size_t i = 0; i < distances.size(); i++)
+        _order[begin + 1 + i] = distances[i].second;
+
+    build(begin + 1, split, threads);
+    build(split, end, threads);
+}
+
+std::size_t SimilarityIndex::size() const {
+    return _graphs.size();
+}
+
+std::size_t SimilarityIndex::buildEvaluations() const {
+    return _buildEvaluations;
+}
+
+// Keeps the k closest graphs seen so far, the reach of the search is the distance of the farthest of them.
+class NearestCollector {
+  private:
+    std::size_t _k;
+    // (distance, graph), the farthest on top
+    std::priority_queue<std::pair<std::size_t, std::size_t>> _heap;
+
+  public:
+    NearestCollector(std::size_t k) : _k(k) {
+    }
+
+    std::size_t reach() const {
+        return _heap.size() < _k ? std::numeric_limits<std::size_t>::max() : _heap.top().first;
+    }
+    void add(std::size_t graph, std::size_t distance) {
+        if (_heap.size() < _k) {
+            _heap.emplace(distance, graph);
+        } else if (std::make_pair(distance, graph) < _heap.top()) {
+            _heap.pop();
+            _heap.emplace(distance, graph);
+        }
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> take() {
+        std::vector<std::pair<std::size_t, std::size_t>> result;
+        for (; !_heap.empty(); _heap.pop())
+            result.emplace_back(_heap.top().second, _heap.top().first);
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+};
+
+// Keeps every graph within a fixed radius.
+class RangeCollector {
+  private:
+    std::size_t _radius;
+    // (distance, graph)
+    std::vector<std::pair<std::size_t, std::size_t>> _found;
+
+  public:
+    RangeCollector(std::size_t radius) : _radius(radius) {
+    }
+
+    std::size_t reach() const {
+        return _radius;
+    }
+    void add(std::size_t graph, std::size_t distance) {
+        if (distance <= _radius) _found.emplace_back(distance, graph);
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> take() {
+        std::sort(_found.begin(), _found.end());
+        std::vector<std::pair<std::size_t, std::size_t>> result;
+        for (auto [distance, graph] : _found)
+            result.emplace_back(graph, distance);
+        return result;
+    }
+};
+
+// whether a graph at distance at least `from` of the query may lie within reach of it at distance `to`
+inline static bool reachable(std::size_t from, std::size_t to, std::size_t reach) {
+    return from <= to || from - to <= reach;
+}
+
+template <typename Collector>
+void SimilarityIndex::search(std::size_t begin, std::size_t end, const CachedGraph& query, Collector& collector,
+                             std::size_t& evaluations) const {
+    if (begin >= end) return;
+    const auto vantage = _order[begin];
+    const auto radius = _radius[begin];
+    const auto split = _split[begin];
+
+    // Graphs inside are within radius of the vantage graph, so at least d - radius from the query, those outside at
+    // least radius - d. A lower bound of d rules out the vantage graph and possibly the inside without evaluating d.
+    auto bound = _metric.lowerBound(query, _graphs[vantage]);
+    if (bound > collector.reach()) {
+        if (reachable(bound, radius, collector.reach())) search(begin + 1, split, query, collector, evaluations);
+        search(split, end, query, collector, evaluations);
+        return;
+    }
+
+    auto distance = _metric.distance(query, _graphs[vantage]);
+    evaluations++;
+    collector.add(vantage, distance);
+
+    // the side of the query first, it is the more likely to shrink the reach
+    if (distance <= radius) {
+        search(begin + 1, split, query, collector, evaluations);
+        if (reachable(radius, distance, collector.reach())) search(split, end, query, collector, evaluations);
+    } else {
+        search(split, end, query, collector, evaluations);
+        if (reachable(distance, radius, collector.reach())) search(begin + 1, split, query, collector, evaluations);
+    }
+}
+
+SearchResult SimilarityIndex::nearest(const core::Multigraph& query, std::size_t k) const {
+    SearchResult result;
+    if (k == 0) return result;
+    const auto cachedQuery = CachedGraph(query);
+    NearestCollector collector(k);
+    search(0, _order.size(), cachedQuery, collector, result.evaluations);
+    result.neighbours = collector.take();
+    return result;
+}
+
+SearchResult SimilarityIndex::within(const core::Multigraph& query, std::size_t radius) const {
+    SearchResult result;
+    const auto cachedQuery = CachedGraph(query);
+    RangeCollector collector(radius);
+    search(0, _order.size(), cachedQuery, collector, result.evaluations);
+    result.neighbours = collector.take();
+    return result;
+}
+
+} // namespace metric
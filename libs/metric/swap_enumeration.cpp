@@ -0,0 +1,40 @@
+#include "swap_enumeration.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace metric
+{
+
+SwapEnumeration::SwapEnumeration(const core::Multigraph& G, const core::Multigraph& H) : _graphs(G, H) {
+}
+
+std::size_t SwapEnumeration::solve() const {
+    const auto n = _graphs.n;
+    auto assignment = std::vector<vertex>(n);
+    std::iota(assignment.begin(), assignment.end(), 0);
+
+    auto cost = mappingCost(_graphs, assignment);
+    auto minCost = cost;
+
+    // iterative Heap's algorithm, counters[i] drives the swaps of the first i + 1 positions
+    auto counters = std::vector<std::size_t>(n, 0);
+    for (std::size_t i = 1; i < n;) {
+        if (counters[i] < i) {
+            auto j = i % 2 == 0 ? 0 : counters[i];
+            cost += swapDelta(_graphs, assignment, j, i);
+            std::swap(assignment[j], assignment[i]);
+            minCost = std::min(minCost, cost);
+            counters[i]++;
+            i = 1;
+        } else {
+            counters[i] = 0;
+            i++;
+        }
+    }
+    return minCost;
+}
+
+} // namespace metric
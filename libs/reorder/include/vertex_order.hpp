@@ -0,0 +1,43 @@
+#pragma once
+
+#include "core.hpp"
+#include <string>
+#include <vector>
+
+namespace reorder
+{
+enum class Strategy {
+    // keep the input labels
+    None,
+    // vertices with the most k-arcs first
+    DegreeDescending,
+    // reverse Cuthill-McKee: breadth-first layers of the undirected k-graph, low degrees first, reversed
+    ReverseCuthillMcKee,
+    // strongly connected components of the k-graph stored contiguously, largest component first
+    StronglyConnectedGroups,
+};
+
+Strategy parseStrategy(const std::string& name);
+
+// Relabeling of the vertices of a multigraph. Vertex v of the reordered graph is vertex original(v) of the input,
+// results computed on the reordered graph are mapped back with the restore functions.
+class VertexOrder {
+  private:
+    std::vector<vertex> _order;
+    std::vector<vertex> _position;
+
+  public:
+    VertexOrder(std::vector<vertex> order);
+    // orders the vertices by the structure of the k-graph of multiGraph
+    static VertexOrder compute(const core::Multigraph& multiGraph, Strategy strategy, unsigned int k = 1);
+
+    vertex original(vertex v) const;
+    vertex relabeled(vertex v) const;
+
+    core::Multigraph apply(const core::Multigraph& multiGraph) const;
+    // maps a closed vertex cycle back and rotates it to start from its smallest original label
+    std::vector<vertex> restoreCycle(const std::vector<vertex>& cycle) const;
+    std::vector<std::vector<vertex>> restoreCycles(const std::vector<std::vector<vertex>>& cycles) const;
+    std::vector<std::vector<std::size_t>> restoreMatrix(const std::vector<std::vector<std::size_t>>& matrix) const;
+};
+} // namespace reorder
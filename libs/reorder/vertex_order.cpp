@@ -0,0 +1,167 @@
+#include "vertex_order.hpp"
+#include "bit_graph.hpp"
+#include "solver_graph.hpp"
+#include "strongly_connected_components.hpp"
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace reorder
+{
+Strategy parseStrategy(const std::string& name) {
+    if (name == "none") return Strategy::None;
+    if (name == "degree") return Strategy::DegreeDescending;
+    if (name == "rcm") return Strategy::ReverseCuthillMcKee;
+    if (name == "scc") return Strategy::StronglyConnectedGroups;
+    throw std::invalid_argument("Unknown vertex order: " + name);
+}
+
+VertexOrder::VertexOrder(std::vector<vertex> order) : _order(std::move(order)), _position(_order.size(), 0) {
+    std::vector<bool> seen(_order.size(), false);
+    for (vertex v = 0; v < _order.size(); v++) {
+        if (_order[v] >= _order.size() || seen[_order[v]]) {
+            throw std::invalid_argument("Vertex order must be a permutation");
+        }
+        seen[_order[v]] = true;
+        _position[_order[v]] = v;
+    }
+}
+
+// number of k-arcs entering or leaving every vertex
+static std::vector<std::size_t> arcDegrees(const core::KThresholdBitGraph& kGraph) {
+    std::vector<std::size_t> degrees(kGraph.vertexCount(), 0);
+    for (vertex u = 0; u < kGraph.vertexCount(); u++) {
+        for (vertex v : kGraph.neighbours(u)) {
+            degrees[u]++;
+            degrees[v]++;
+        }
+    }
+    return degrees;
+}
+
+static std::vector<vertex> reverseCuthillMcKee(const core::KThresholdBitGraph& kGraph,
+                                               const std::vector<std::size_t>& degrees) {
+    const std::size_t n = kGraph.vertexCount();
+    std::vector<std::vector<vertex>> undirected(n);
+    for (vertex u = 0; u < n; u++) {
+        for (vertex v : kGraph.neighbours(u)) {
+            undirected[u].push_back(v);
+            if (!kGraph.hasEdge(v, u)) undirected[v].push_back(u);
+        }
+    }
+    auto byDegree = [&](vertex a, vertex b) { return degrees[a] < degrees[b]; };
+    for (auto& neighbours : undirected) {
+        std::stable_sort(neighbours.begin(), neighbours.end(), byDegree);
+    }
+
+    std::vector<vertex> byDegreeOrder(n);
+    std::iota(byDegreeOrder.begin(), byDegreeOrder.end(), 0);
+    std::stable_sort(byDegreeOrder.begin(), byDegreeOrder.end(), byDegree);
+
+    std::vector<vertex> order;
+    std::vector<bool> visited(n, false);
+    std::queue<vertex> queue;
+    // every weakly connected component starts from its vertex of minimal degree
+    for (vertex start : byDegreeOrder) {
+        if (visited[start]) continue;
+        visited[start] = true;
+        queue.push(start);
+        while (!queue.empty()) {
+            vertex u = queue.front();
+            queue.pop();
+            order.push_back(u);
+            for (vertex v : undirected[u]) {
+                if (visited[v]) continue;
+                visited[v] = true;
+                queue.push(v);
+            }
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+VertexOrder VertexOrder::compute(const core::Multigraph& multiGraph, Strategy strategy, unsigned int k) {
+    const std::size_t n = multiGraph.vertexCount();
+    std::vector<vertex> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if (strategy == Strategy::None) return VertexOrder(std::move(order));
+
+    const core::KThresholdBitGraph kGraph(multiGraph, k);
+    const auto degrees = arcDegrees(kGraph);
+    auto byDegreeDescending = [&](vertex a, vertex b) { return degrees[a] > degrees[b]; };
+
+    switch (strategy) {
+    case Strategy::None:
+        break;
+    case Strategy::DegreeDescending:
+        std::stable_sort(order.begin(), order.end(), byDegreeDescending);
+        break;
+    case Strategy::ReverseCuthillMcKee:
+        order = reverseCuthillMcKee(kGraph, degrees);
+        break;
+    case Strategy::StronglyConnectedGroups: {
+        auto components = cycleFinder::StronglyConnectedComponents(cycleFinder::SolverGraph(kGraph)).solve();
+        const auto bySizeDescending = [](const std::vector<vertex>& a, const std::vector<vertex>& b) {
+            return a.size() > b.size();
+        };
+        std::stable_sort(components.begin(), components.end(), bySizeDescending);
+        order.clear();
+        for (auto& component : components) {
+            std::sort(component.begin(), component.end());
+            std::stable_sort(component.begin(), component.end(), byDegreeDescending);
+            order.insert(order.end(), component.begin(), component.end());
+        }
+        break;
+    }
+    }
+    return VertexOrder(std::move(order));
+}
+
+vertex VertexOrder::original(vertex v) const {
+    return _order[v];
+}
+
+vertex VertexOrder::relabeled(vertex v) const {
+    return _position[v];
+}
+
+core::Multigraph VertexOrder::apply(const core::Multigraph& multiGraph) const {
+    return multiGraph.inducedSubgraph(_order);
+}
+
+std::vector<vertex> VertexOrder::restoreCycle(const std::vector<vertex>& cycle) const {
+    if (cycle.empty()) return cycle;
+    // drop the closing repetition, rotate, then close the cycle again
+    std::vector<vertex> restored;
+    for (std::size_t i = 0; i + 1 < cycle.size(); i++) {
+        restored.push_back(_order[cycle[i]]);
+    }
+    if (restored.empty()) return {_order[cycle[0]]};
+    std::rotate(restored.begin(), std::min_element(restored.begin(), restored.end()), restored.end());
+    restored.push_back(restored.front());
+    return restored;
+}
+
+std::vector<std::vector<vertex>> VertexOrder::restoreCycles(const std::vector<std::vector<vertex>>& cycles) const {
+    std::vector<std::vector<vertex>> restored;
+    restored.reserve(cycles.size());
+    for (const auto& cycle : cycles) {
+        restored.push_back(restoreCycle(cycle));
+    }
+    return restored;
+}
+
+std::vector<std::vector<std::size_t>> VertexOrder::restoreMatrix(
+    const std::vector<std::vector<std::size_t>>& matrix) const {
+    std::vector<std::vector<std::size_t>> restored(matrix.size(), std::vector<std::size_t>(matrix.size(), 0));
+    for (vertex u = 0; u < matrix.size(); u++) {
+        for (vertex v = 0; v < matrix.size(); v++) {
+            restored[_order[u]][_order[v]] = matrix[u][v];
+        }
+    }
+    return restored;
+}
+} // namespace reorder
@@ -1,5 +1,6 @@
 #include "benchmark/benchmark.h"
 #include "core.hpp"
+#include "bit_graph.hpp"
 #include "hamilton.hpp"
 #include <cstddef>
 #include <vector>
@@ -59,5 +60,29 @@ static void BM_hamilton_k_cycles_approximation_changing_k(benchmark::State& stat
     }
 }
 
+// sparse k-graph of out-degree 8 with n / 4 extension arcs, counted on the bit graph by either max-flow algorithm
+static void BM_hamilton_k_cycles_flow_algorithm_large_n(benchmark::State& state) {
+    const std::size_t n = state.range(0);
+    const auto algorithm = static_cast<hamilton::FlowAlgorithm>(state.range(1));
+    core::Multigraph G(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (int arc = 0; arc < 8; ++arc) {
+            G.addEdge(i, rand() % n);
+        }
+    }
+
+    std::vector<std::vector<std::size_t>> extensionMatrix(n, std::vector<std::size_t>(n, 0));
+    for (std::size_t arc = 0; arc < n / 4; ++arc) {
+        extensionMatrix[rand() % n][rand() % n] = 1;
+    }
+    core::KThresholdBitGraph kGraph(G, 1);
+
+    for (auto _ : state) {
+        auto dist = hamilton::findAllHamiltonianCycles(kGraph, extensionMatrix, algorithm);
+        benchmark::DoNotOptimize(dist);
+    }
+}
+
 BENCHMARK(BM_hamilton_k_cycles_approximation_changing_k)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
 BENCHMARK(BM_hamilton_k_cycles_approximation_changing_n)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
+BENCHMARK(BM_hamilton_k_cycles_flow_algorithm_large_n)->ArgsProduct({{1024, 2048, 4096, 8192}, {0, 1}})->Setup(Setup);
@@ -1,6 +1,7 @@
 #include "benchmark/benchmark.h"
 #include "core.hpp"
 #include "hamilton.hpp"
+#include <chrono>
 
 static void Setup(const benchmark::State& state) {
     srand(100);
@@ -26,6 +27,80 @@ static void BM_hamiltonian_extension_exact_n_changing(benchmark::State& state) {
     }
 }
 
+static void BM_hamiltonian_extension_exact_large_n_changing(benchmark::State& state) {
+    const auto n = state.range(0);
+    const std::size_t k = 2;
+    const auto G = core::Multigraph::random(n, 2 * n);
+
+    for (auto _ : state) {
+        auto extension = hamilton::findKHamiltonianExtension(k, G, false);
+    }
+}
+
+// a path of k-arcs through three quarters of the vertices over a few random arcs, mostly contracted before solving
+static void BM_hamiltonian_extension_exact_planted_path(benchmark::State& state) {
+    const std::size_t n = state.range(0);
+    const std::size_t k = 1;
+    auto G = core::Multigraph::random(n, n / 4);
+    for (std::size_t v = 0; v + 1 < 3 * n / 4; ++v) {
+        G.addEdge(v, v + 1);
+    }
+
+    for (auto _ : state) {
+        auto extension = hamilton::findKHamiltonianExtension(k, G, false);
+    }
+}
+
+// k from 1 to 8 solved one at a time (argument 0) or as one sweep warm-starting each k from the previous one (1)
+static void BM_hamiltonian_extension_exact_k_sweep(benchmark::State& state) {
+    const std::size_t n = state.range(0);
+    const bool sweep = state.range(1);
+    const std::size_t kFirst = 1, kLast = 8;
+    const auto G = core::Multigraph::random(n, 4 * n);
+
+    for (auto _ : state) {
+        if (sweep) {
+            auto extensions = hamilton::findKHamiltonianExtensions(kFirst, kLast, G, false);
+        } else {
+            for (std::size_t k = kFirst; k <= kLast; ++k) {
+                auto extension = hamilton::findKHamiltonianExtension(k, G, false);
+            }
+        }
+    }
+}
+
+static void BM_hamiltonian_extension_exact_threads_changing(benchmark::State& state) {
+    const auto threads = state.range(0);
+    const std::size_t n = 20;
+    const std::size_t k = n + 2;
+    const auto G = core::Multigraph::random(n, n);
+
+    for (auto _ : state) {
+        auto extension =
+            hamilton::findKHamiltonianExtension(k, G, false, threads, {}, 0, hamilton::ATSPEngine::HeldKarp);
+    }
+    state.counters["threads"] = threads;
+}
+
+// every arc doubled in the opposite direction, which loosens the assignment bound and grows the branch and bound tree
+static void BM_hamiltonian_extension_exact_branch_and_bound_threads_changing(benchmark::State& state) {
+    const auto threads = state.range(0);
+    const std::size_t n = 32;
+    const std::size_t k = 3;
+    auto G = core::Multigraph(n);
+    for (std::size_t e = 0; e < 4 * n; ++e) {
+        const std::size_t u = rand() % n, v = rand() % n;
+        G.addEdge(u, v);
+        G.addEdge(v, u);
+    }
+
+    for (auto _ : state) {
+        auto extension =
+            hamilton::findKHamiltonianExtension(k, G, false, threads, {}, 0, hamilton::ATSPEngine::BranchAndBound);
+    }
+    state.counters["threads"] = threads;
+}
+
 static void BM_hamiltonian_extension_approximation_k_changing(benchmark::State& state) {
     const auto k = state.range(0);
     const std::size_t n = 1024;
@@ -46,7 +121,43 @@ static void BM_hamiltonian_extension_approximation_n_changing(benchmark::State&
     }
 }
 
+static void BM_hamiltonian_extension_approximation_multi_start(benchmark::State& state) {
+    const auto threads = state.range(0);
+    const std::size_t n = 512;
+    const std::size_t k = 2;
+    const auto G = core::Multigraph::random(n, 2 * n);
+
+    std::size_t size = 0;
+    for (auto _ : state) {
+        auto extension = hamilton::findKHamiltonianExtension(k, G, true, threads, std::chrono::milliseconds(100));
+        size = 0;
+        for (const auto& row : extension)
+            for (auto multiplicity : row)
+                size += multiplicity;
+    }
+    state.counters["threads"] = threads;
+    state.counters["size"] = size;
+}
+
 BENCHMARK(BM_hamiltonian_extension_exact_k_changing)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
 BENCHMARK(BM_hamiltonian_extension_approximation_k_changing)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
 BENCHMARK(BM_hamiltonian_extension_exact_n_changing)->DenseRange(2, 24, 2)->Setup(Setup);
+BENCHMARK(BM_hamiltonian_extension_exact_large_n_changing)->DenseRange(16, 64, 8)->Setup(Setup);
+BENCHMARK(BM_hamiltonian_extension_exact_planted_path)->DenseRange(16, 64, 8)->Setup(Setup);
+BENCHMARK(BM_hamiltonian_extension_exact_k_sweep)->ArgsProduct({{16, 24, 32}, {0, 1}})->Setup(Setup);
+BENCHMARK(BM_hamiltonian_extension_exact_threads_changing)
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime()
+    ->Setup(Setup);
+BENCHMARK(BM_hamiltonian_extension_exact_branch_and_bound_threads_changing)
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime()
+    ->Setup(Setup);
 BENCHMARK(BM_hamiltonian_extension_approximation_n_changing)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
+BENCHMARK(BM_hamiltonian_extension_approximation_multi_start)
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime()
+    ->Setup(Setup);
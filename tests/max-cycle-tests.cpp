@@ -1,6 +1,7 @@
 #include "benchmark/benchmark.h"
 #include "core.hpp"
 #include "max_cycle_solver.hpp"
+#include "vertex_order.hpp"
 
 static void Setup(const benchmark::State& state) {
     srand(100);
@@ -48,8 +49,39 @@ static void BM_max_cycle_exact_changing_k(benchmark::State& state) {
     }
 }
 
+static void BM_max_cycle_exact_degree_order_changing_n(benchmark::State& state) {
+    auto solver = cycleFinder::MaxCycleSolver();
+    const auto n = state.range(0);
+    const auto G = core::Multigraph::random(n, n * n);
+
+    for (auto _ : state) {
+        const auto order = reorder::VertexOrder::compute(G, reorder::Strategy::DegreeDescending);
+        auto cycles = order.restoreCycles(solver.solve(order.apply(G), 1));
+    }
+}
+
+// k from 1 to 8 searched one at a time (argument 0) or as one sweep pruning the vertices left acyclic by the previous k
+static void BM_max_cycle_exact_k_sweep(benchmark::State& state) {
+    auto solver = cycleFinder::MaxCycleSolver();
+    const auto n = state.range(0);
+    const bool sweep = state.range(1);
+    const auto G = core::Multigraph::random(n, n * n);
+
+    for (auto _ : state) {
+        if (sweep) {
+            auto results = solver.sweep(G, 1, 8, false);
+        } else {
+            for (unsigned int k = 1; k <= 8; ++k) {
+                auto cycles = solver.solve(G, k);
+            }
+        }
+    }
+}
+
 BENCHMARK(BM_max_cycle_approximation_changing_n)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
 BENCHMARK(BM_max_cycle_exact_changing_n)->DenseRange(2, 15)->Setup(Setup);
+BENCHMARK(BM_max_cycle_exact_degree_order_changing_n)->DenseRange(2, 15)->Setup(Setup);
 
 BENCHMARK(BM_max_cycle_approximation_changing_k)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
 BENCHMARK(BM_max_cycle_exact_changing_k)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
+BENCHMARK(BM_max_cycle_exact_k_sweep)->ArgsProduct({{6, 8, 10}, {0, 1}})->Setup(Setup);
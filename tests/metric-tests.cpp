@@ -1,11 +1,32 @@
 #include "benchmark/benchmark.h"
+#include "anytime_metric.hpp"
+#include "assignment_metric.hpp"
 #include "core.hpp"
+#include "graph_signature.hpp"
+#include "kernels.hpp"
 #include "metric.hpp"
+#include "similarity_index.hpp"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <vector>
 
 static void Setup(const benchmark::State& state) {
     srand(100);
 }
 
+// G with its vertex labels reversed and `extraEdges` random edges added, close to G but not aligned with it
+static core::Multigraph perturbedCopy(const core::Multigraph& G, std::size_t extraEdges) {
+    const std::size_t n = G.vertexCount();
+    auto relabeling = std::vector<vertex>(n);
+    std::iota(relabeling.begin(), relabeling.end(), 0);
+    std::reverse(relabeling.begin(), relabeling.end());
+    auto H = G.inducedSubgraph(relabeling);
+    for (std::size_t i = 0; i < extraEdges; i++)
+        H.addEdge(rand() % n, rand() % n);
+    return H;
+}
+
 static void BM_ExactMetric(benchmark::State& state) {
     metric::ExactMetric distFun;
     const auto n = state.range(0);
@@ -17,6 +38,120 @@ static void BM_ExactMetric(benchmark::State& state) {
     }
 }
 
+static void BM_ExactMetric_Perturbed(benchmark::State& state) {
+    metric::ExactMetric distFun;
+    const auto n = state.range(0);
+    const auto G = core::Multigraph::random(n, n * n);
+    const auto H = perturbedCopy(G, 4);
+
+    for (auto _ : state) {
+        auto dist = distFun(G, H);
+    }
+}
+
+static void BM_ExactMetric_CachedRelabeled(benchmark::State& state) {
+    metric::ExactMetric distFun;
+    const auto n = state.range(0);
+    const auto G = metric::CachedGraph(core::Multigraph::random(n, n * n));
+    const auto H = metric::CachedGraph(perturbedCopy(G.graph, 0));
+
+    for (auto _ : state) {
+        auto dist = distFun.distance(G, H);
+    }
+}
+
+static void BM_ExactMetric_Threads(benchmark::State& state) {
+    metric::ExactMetric distFun(state.range(0));
+    const auto n = 12;
+    const auto G = core::Multigraph::random(n, n * n);
+    const auto H = core::Multigraph::random(n, n * n);
+
+    for (auto _ : state) {
+        auto dist = distFun(G, H);
+    }
+    state.counters["threads"] = state.range(0);
+}
+
+static void BM_AssignmentMetric_Perturbed(benchmark::State& state) {
+    metric::AssignmentMetric distFun(state.range(1));
+    const auto n = state.range(0);
+    const auto G = core::Multigraph::random(n, n * n);
+    const auto H = perturbedCopy(G, 4);
+
+    for (auto _ : state) {
+        auto dist = distFun(G, H);
+    }
+}
+
+static void BM_AnytimeMetric(benchmark::State& state) {
+    metric::AnytimeMetric distFun(std::chrono::milliseconds(state.range(1)));
+    const auto n = state.range(0);
+    const auto G = core::Multigraph::random(n, n * n);
+    const auto H = core::Multigraph::random(n, n * n);
+
+    std::size_t gap = 0;
+    for (auto _ : state) {
+        auto bounds = distFun.bounds(G, H);
+        gap = bounds.upperBound - bounds.lowerBound;
+    }
+    state.counters["gap"] = gap;
+}
+
+static void BM_SimilarityIndex_Nearest(benchmark::State& state) {
+    metric::ExactMetric distFun;
+    const std::size_t count = state.range(0);
+    auto graphs = std::vector<core::Multigraph>();
+    for (std::size_t i = 0; i < count; i++) {
+        auto n = 4 + rand() % 4;
+        graphs.push_back(core::Multigraph::random(n, 2 * n));
+    }
+    const auto index = metric::SimilarityIndex(graphs, distFun);
+    const auto query = core::Multigraph::random(6, 12);
+
+    std::size_t evaluations = 0;
+    for (auto _ : state) {
+        evaluations = index.nearest(query, 5).evaluations;
+    }
+    state.counters["evaluations"] = evaluations;
+}
+
+static void BM_AbsDiffSum(benchmark::State& state) {
+    const auto level = static_cast<metric::SimdLevel>(state.range(0));
+    if (level > metric::detectSimdLevel()) return state.SkipWithError("instruction set not supported");
+    const std::size_t size = state.range(1);
+    auto a = std::vector<std::size_t>(size);
+    auto b = std::vector<std::size_t>(size);
+    for (std::size_t i = 0; i < size; i++) {
+        a[i] = rand() % 8;
+        b[i] = rand() % 8;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(metric::absDiffSum(a.data(), b.data(), size, level));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+static void BM_AbsDiffSumGathered(benchmark::State& state) {
+    const auto level = static_cast<metric::SimdLevel>(state.range(0));
+    if (level > metric::detectSimdLevel()) return state.SkipWithError("instruction set not supported");
+    const std::size_t size = state.range(1);
+    auto a = std::vector<std::size_t>(size);
+    auto row = std::vector<std::size_t>(size);
+    auto index = std::vector<vertex>(size);
+    std::iota(index.begin(), index.end(), 0);
+    for (std::size_t i = 0; i < size; i++) {
+        a[i] = rand() % 8;
+        row[i] = rand() % 8;
+        std::swap(index[i], index[rand() % (i + 1)]);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(metric::absDiffSumGathered(a.data(), row.data(), index.data(), size, level));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
 static void BM_HeuristicMetric_ComparisonSort_DegreeLinear(benchmark::State& state) {
     metric::HeuristicMetric distFun(false);
     const auto n = state.range(0);
@@ -62,6 +197,16 @@ static void BM_HeuristicMetric_CountingSort_DegreeConstant(benchmark::State& sta
 }
 
 BENCHMARK(BM_ExactMetric)->DenseRange(2, 11)->Setup(Setup);
+BENCHMARK(BM_ExactMetric_Perturbed)->DenseRange(12, 20, 2)->Setup(Setup);
+BENCHMARK(BM_ExactMetric_CachedRelabeled)->RangeMultiplier(2)->Range(16, 256)->Setup(Setup);
+BENCHMARK(BM_ExactMetric_Threads)->RangeMultiplier(2)->Range(1, 32)->UseRealTime()->Setup(Setup);
+BENCHMARK(BM_AssignmentMetric_Perturbed)->ArgsProduct({{25, 50, 100, 200}, {0, 1}})->Setup(Setup);
+BENCHMARK(BM_AnytimeMetric)->ArgsProduct({{16, 64, 200}, {1, 10, 100}})->UseRealTime()->Setup(Setup);
+BENCHMARK(BM_SimilarityIndex_Nearest)->RangeMultiplier(4)->Range(64, 4096)->Setup(Setup);
+
+// first argument: 0 scalar, 1 AVX2, 2 AVX-512
+BENCHMARK(BM_AbsDiffSum)->ArgsProduct({{0, 1, 2}, {16, 256, 4096}});
+BENCHMARK(BM_AbsDiffSumGathered)->ArgsProduct({{0, 1, 2}, {16, 256, 4096}});
 BENCHMARK(BM_HeuristicMetric_ComparisonSort_DegreeLinear)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
 BENCHMARK(BM_HeuristicMetric_ComparisonSort_DegreeConstant)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);
 BENCHMARK(BM_HeuristicMetric_CountingSort_DegreeLinear)->RangeMultiplier(2)->Range(8, 4096)->Setup(Setup);